@@ -0,0 +1,53 @@
+#include "aggregate.h"
+#include <cmath>
+#include <algorithm>
+
+/////////////////////////// AggregateState /////////////////////////////////
+
+void AggregateState::add(const double value, const bool trackVariance) {
+  ++count;
+  sum += value;
+  min = std::min(min, value);
+  max = std::max(max, value);
+
+  if (!trackVariance) return;
+
+  double delta = value - mean;
+  mean += delta / count;
+  m2 += delta * (value - mean);
+}
+
+// Chan et al.'s pairwise combination of the Welford moments
+void AggregateState::merge(const AggregateState &other) {
+  if (other.count == 0) return;
+
+  if (count == 0) {
+    *this = other;
+    return;
+  }
+
+  int64_t total = count + other.count;
+  double delta = other.mean - mean;
+
+  mean += delta * other.count / total;
+  m2 += other.m2 + delta * delta * count * other.count / total;
+
+  count = total;
+  sum += other.sum;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+}
+
+double AggregateState::avg() const {
+  return sum / count;
+}
+
+double AggregateState::variance() const {
+  return m2 / count;
+}
+
+double AggregateState::standardDeviation() const {
+  return std::sqrt(variance());
+}
+
+///////////////////////// AggregateState end ///////////////////////////////
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+// Aggregates Column::aggregate can compute in one pass, combine them with |
+enum class Aggregate : unsigned {
+  COUNT = 1 << 0,
+  SUM = 1 << 1,
+  MIN = 1 << 2,
+  MAX = 1 << 3,
+  AVG = 1 << 4,
+  VARIANCE = 1 << 5,
+  STDDEV = 1 << 6,
+  ALL = (1 << 7) - 1
+};
+
+inline Aggregate operator|(const Aggregate lhs, const Aggregate rhs) {
+  return static_cast<Aggregate>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+// True if any of which is in requested
+inline bool requests(const Aggregate requested, const Aggregate which) {
+  return static_cast<unsigned>(requested) & static_cast<unsigned>(which);
+}
+
+// Running state of the numeric aggregates over a set of values. The variance is kept
+// with Welford's updates (mean and sum of squared distances to it), which stay accurate
+// where summing squares would cancel out. States over disjoint sets of values merge
+// into the state of their union, so partial states (per segment, per thread...) can
+// be combined in any order
+struct AggregateState {
+  int64_t count = 0;
+  double sum = 0;
+
+  // Same starting points as Column::min/max, which is what they return on no values
+  double min = std::numeric_limits<double>::max();
+  double max = std::numeric_limits<double>::lowest();
+
+  // Only maintained when the variance is tracked
+  double mean = 0;
+  double m2 = 0;
+
+  void add(const double value, const bool trackVariance=true);
+  void merge(const AggregateState &other);
+
+  double avg() const;
+
+  // Population variance and standard deviation (divided by count)
+  double variance() const;
+  double standardDeviation() const;
+};
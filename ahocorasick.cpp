@@ -0,0 +1,67 @@
+#include "ahocorasick.h"
+#include <queue>
+
+/////////////////////////// AhoCorasick /////////////////////////////////
+
+AhoCorasick::AhoCorasick(const vector<string> &patterns) {
+  array<int, 256> none;
+  none.fill(-1);
+
+  transitions.push_back(none);
+  depths.push_back(0);
+  longestOutput.push_back(-1);
+
+  // Trie of the patterns, -1 marks missing edges for now
+  for (size_t p = 0; p < patterns.size(); ++p) {
+    patternLengths.push_back(patterns[p].size());
+    if (patterns[p].empty()) continue;
+
+    int state = 0;
+    for (char c : patterns[p]) {
+      int &next = transitions[state][static_cast<uint8_t>(c)];
+
+      if (next == -1) {
+        next = transitions.size();
+        transitions.push_back(none);
+        depths.push_back(depths[state] + 1);
+        longestOutput.push_back(-1);
+      }
+
+      state = transitions[state][static_cast<uint8_t>(c)];
+    }
+
+    if (longestOutput[state] == -1) longestOutput[state] = p;
+  }
+
+  // Breadth first, so every state's failure target is complete before it is needed.
+  // Missing edges take the failure target's edge, which turns the trie into a DFA
+  vector<int> failure(transitions.size(), 0);
+  queue<int> pending;
+
+  for (int &next : transitions[0]) {
+    if (next == -1) next = 0;
+    else pending.push(next);
+  }
+
+  while (!pending.empty()) {
+    int state = pending.front();
+    pending.pop();
+
+    // A state's own pattern is longer than anything it inherits from its failure target
+    if (longestOutput[state] == -1) longestOutput[state] = longestOutput[failure[state]];
+
+    for (int c = 0; c < 256; ++c) {
+      int &next = transitions[state][c];
+
+      if (next == -1) {
+        next = transitions[failure[state]][c];
+        continue;
+      }
+
+      failure[next] = transitions[failure[state]][c];
+      pending.push(next);
+    }
+  }
+}
+
+///////////////////////// AhoCorasick end ///////////////////////////////
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+using namespace std;
+
+// Aho-Corasick automaton over a set of byte patterns, compiled once and then run over
+// any number of texts. The trie's failure links are folded into a full transition
+// table, so matching costs one table lookup per byte whatever the number of patterns.
+// Empty patterns never match; of duplicate patterns the first one is reported
+class AhoCorasick {
+  public:
+    AhoCorasick(const vector<string> &patterns);
+
+    // Calls onMatch(start, length, pattern) for the non overlapping matches in text,
+    // left to right. The leftmost match wins, and of the matches starting there the
+    // longest. Scanning goes on after the end of each reported match
+    template <typename Func>
+    void forEachMatch(string_view text, Func &&onMatch) const {
+      size_t position = 0;
+
+      while (position < text.size()) {
+        int state = 0;
+        bool found = false;
+        size_t bestStart = 0;
+        int bestPattern = -1;
+
+        size_t i = position;
+        for (; i < text.size(); ++i) {
+          state = transitions[state][static_cast<uint8_t>(text[i])];
+
+          // Longest pattern ending here, which is the earliest starting one
+          int pattern = longestOutput[state];
+          if (pattern != -1) {
+            size_t start = i + 1 - patternLengths[pattern];
+
+            // Same start seen later means a longer match
+            if (!found || start <= bestStart) {
+              found = true;
+              bestStart = start;
+              bestPattern = pattern;
+            }
+          }
+
+          // Whatever matches later starts inside the current trie path, past the best
+          if (found && i + 1 - depths[state] > bestStart) break;
+        }
+
+        if (!found) return;
+
+        onMatch(bestStart, patternLengths[bestPattern], bestPattern);
+        position = bestStart + patternLengths[bestPattern];
+      }
+    }
+
+  private:
+    vector<array<int, 256>> transitions;
+    vector<int> depths;
+
+    // Index of the longest pattern that is a suffix of the state's path, -1 if none
+    vector<int> longestOutput;
+    vector<int> patternLengths;
+};
@@ -0,0 +1,75 @@
+#include "arena.h"
+
+///////////////////////////// StringArena /////////////////////////////////
+
+int StringArena::size() const {
+  return slices.size();
+}
+
+void StringArena::reserve(int capacity, int bytesPerCell) {
+  slices.reserve(capacity);
+  bytes.reserve(static_cast<size_t>(capacity) * bytesPerCell);
+}
+
+string StringArena::operator[] (int index) const {
+  return string(view(index));
+}
+
+void StringArena::push_back(string_view value) {
+  slices.push_back(append(value));
+}
+
+// The old bytes stay behind as garbage until the next compaction
+void StringArena::set(int index, string_view value) {
+  wasted += slices[index].length;
+  slices[index] = append(value);
+
+  compactIfWasteful();
+}
+
+void StringArena::pop_back() {
+  const Slice &last = slices.back();
+
+  // The last cell is usually at the end of the bytes, so it can be reclaimed right away
+  if (last.offset + last.length == bytes.size()) bytes.resize(last.offset);
+  else wasted += last.length;
+
+  slices.pop_back();
+}
+
+void StringArena::erase(int index) {
+  wasted += slices[index].length;
+  slices.erase(slices.begin() + index);
+
+  compactIfWasteful();
+}
+
+size_t StringArena::wastedBytes() const {
+  return wasted;
+}
+
+StringArena::Slice StringArena::append(string_view value) {
+  Slice slice{bytes.size(), static_cast<uint32_t>(value.size())};
+  bytes.insert(bytes.end(), value.begin(), value.end());
+
+  return slice;
+}
+
+void StringArena::compactIfWasteful() {
+  if (wasted * 2 <= bytes.size()) return;
+
+  vector<char> compacted;
+  compacted.reserve(bytes.size() - wasted);
+
+  for (Slice &slice : slices) {
+    uint64_t offset = compacted.size();
+    compacted.insert(compacted.end(), bytes.begin() + slice.offset,
+                     bytes.begin() + slice.offset + slice.length);
+    slice.offset = offset;
+  }
+
+  bytes = std::move(compacted);
+  wasted = 0;
+}
+
+/////////////////////////// StringArena end ///////////////////////////////
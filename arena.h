@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+using namespace std;
+
+// String buffer for TEXT columns. Every cell's bytes are appended to one shared
+// byte array, and cells are just (offset, length) slices into it, so loading a
+// column costs a handful of reallocations instead of one allocation per cell.
+// Mimics the vector buffers (value_type, operator[], push_back...) like Dictionary does
+class StringArena {
+  public:
+    using value_type = string;
+
+    int size() const;
+    void reserve(int capacity, int bytesPerCell=16);
+
+    // Copies the cell out, prefer view() on hot paths
+    string operator[] (int index) const;
+
+    // Only valid until the next modification of the arena
+    string_view view(int index) const {
+      return string_view(bytes.data() + slices[index].offset, slices[index].length);
+    }
+
+    void push_back(string_view value);
+    void set(int index, string_view value);
+
+    void pop_back();
+    void erase(int index);
+
+    // Bytes held by cells that were overwritten or erased
+    size_t wastedBytes() const;
+
+  private:
+    struct Slice {
+      uint64_t offset;
+      uint32_t length;
+    };
+
+    vector<char> bytes;
+    vector<Slice> slices;
+    size_t wasted = 0;
+
+    Slice append(string_view value);
+
+    // Rewrites bytes keeping only live cells, once garbage outweighs them
+    void compactIfWasteful();
+};
+
+// Buffer for VARCHAR/CHAR columns. Only the characters go into the arena, the
+// declared length is kept once for the whole column (-1 when it can be anything,
+// in which case each value's own size stands in for it). Enforcing that cells fit
+// is left to the column, which checks whole batches at once
+template <typename Logical>
+class CharArena {
+  public:
+    using value_type = Logical;
+
+    CharArena(const int CharLength=-1) : charLength(CharLength) {}
+
+    int size() const {
+      return arena.size();
+    }
+
+    void reserve(int capacity) {
+      arena.reserve(capacity);
+    }
+
+    // Rebuilds the value around the column's length, skipping the constructor checks
+    Logical operator[] (int index) const {
+      Logical cell;
+      cell.value = arena[index];
+      cell.length = charLength == -1 ? cell.value.size() : charLength;
+
+      return cell;
+    }
+
+    string_view view(int index) const {
+      return arena.view(index);
+    }
+
+    void push_back(const Logical &value) {
+      arena.push_back(value.value);
+    }
+
+    void push_back(string_view value) {
+      arena.push_back(value);
+    }
+
+    void set(int index, const Logical &value) {
+      arena.set(index, value.value);
+    }
+
+    void pop_back() {
+      arena.pop_back();
+    }
+
+    void erase(int index) {
+      arena.erase(index);
+    }
+
+    int getCharLength() const {
+      return charLength;
+    }
+
+  private:
+    StringArena arena;
+    int charLength;
+};
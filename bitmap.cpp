@@ -0,0 +1,136 @@
+#include "bitmap.h"
+
+/////////////////////////////// Bitmap ///////////////////////////////////
+
+Bitmap::Bitmap() {}
+
+Bitmap::Bitmap(int Size, bool Value) :
+  words((Size + WORD_BITS - 1) / WORD_BITS, Value ? ~uint64_t(0) : 0), bits(Size) {
+  clearTail();
+}
+
+int Bitmap::size() const {
+  return bits;
+}
+
+void Bitmap::reserve(int capacity) {
+  words.reserve((capacity + WORD_BITS - 1) / WORD_BITS);
+}
+
+void Bitmap::push(bool value) {
+  if (bits % WORD_BITS == 0) words.push_back(0);
+
+  ++bits;
+  set(bits - 1, value);
+}
+
+void Bitmap::append(const uint64_t *source, int count) {
+  int shift = bits % WORD_BITS;
+  int sourceWords = (count + WORD_BITS - 1) / WORD_BITS;
+
+  words.reserve((bits + count + WORD_BITS - 1) / WORD_BITS);
+
+  // Word aligned, so the source words can go in as they are
+  if (shift == 0) {
+    words.insert(words.end(), source, source + sourceWords);
+  }
+  else {
+    for (int w = 0; w < sourceWords; ++w) {
+      words.back() |= source[w] << shift;
+      words.push_back(source[w] >> (WORD_BITS - shift));
+    }
+  }
+
+  bits += count;
+  words.resize((bits + WORD_BITS - 1) / WORD_BITS);
+  clearTail();
+}
+
+void Bitmap::pop() {
+  set(bits - 1, false);
+  --bits;
+
+  if (bits % WORD_BITS == 0) words.pop_back();
+}
+
+void Bitmap::erase(int index) {
+  int word = index / WORD_BITS;
+  int offset = index % WORD_BITS;
+
+  // Inside the first word only the bits above index move down
+  uint64_t below = offset == 0 ? 0 : words[word] & (~uint64_t(0) >> (WORD_BITS - offset));
+  uint64_t above = offset == WORD_BITS - 1 ? 0 : (words[word] >> (offset + 1)) << offset;
+  words[word] = below | above;
+
+  // Every following word shifts by one, borrowing its lowest bit into the previous word
+  for (int w = word + 1; w < static_cast<int>(words.size()); ++w) {
+    words[w - 1] |= (words[w] & 1) << (WORD_BITS - 1);
+    words[w] >>= 1;
+  }
+
+  --bits;
+  if (bits % WORD_BITS == 0) words.pop_back();
+}
+
+int Bitmap::count() const {
+  int total = 0;
+  for (uint64_t word : words) total += std::popcount(word);
+
+  return total;
+}
+
+// Skips whole zero words instead of testing bit by bit
+int Bitmap::nextSet(int from) const {
+  if (from >= bits) return bits;
+
+  int w = from / WORD_BITS;
+  uint64_t word = words[w] & (~uint64_t(0) << (from % WORD_BITS));
+
+  while (!word) {
+    if (++w == static_cast<int>(words.size())) return bits;
+    word = words[w];
+  }
+
+  return w * WORD_BITS + std::countr_zero(word);
+}
+
+bool Bitmap::all() const {
+  return count() == bits;
+}
+
+bool Bitmap::none() const {
+  for (uint64_t word : words) {
+    if (word) return false;
+  }
+
+  return true;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap &rhs) {
+  for (size_t w = 0; w < words.size(); ++w) {
+    words[w] &= w < rhs.words.size() ? rhs.words[w] : 0;
+  }
+
+  return *this;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap &rhs) {
+  for (size_t w = 0; w < words.size() && w < rhs.words.size(); ++w) {
+    words[w] |= rhs.words[w];
+  }
+
+  clearTail();
+  return *this;
+}
+
+const vector<uint64_t>& Bitmap::data() const {
+  return words;
+}
+
+void Bitmap::clearTail() {
+  if (bits % WORD_BITS != 0) {
+    words.back() &= ~uint64_t(0) >> (WORD_BITS - bits % WORD_BITS);
+  }
+}
+
+///////////////////////////// Bitmap end ///////////////////////////////////
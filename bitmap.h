@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <bit>
+
+using namespace std;
+
+// Packed bitset backed by 64 bit words. Bits past size() are always kept at 0,
+// so word-wide operations (popcount, and/or) never need to mask the tail
+class Bitmap {
+  public:
+    Bitmap();
+    Bitmap(int Size, bool Value=false);
+
+    int size() const;
+    void reserve(int capacity);
+
+    bool test(int index) const {
+      return (words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+    void set(int index, bool value) {
+      uint64_t mask = uint64_t(1) << (index % WORD_BITS);
+
+      if (value) words[index / WORD_BITS] |= mask;
+      else words[index / WORD_BITS] &= ~mask;
+    }
+
+    void push(bool value);
+    void pop();
+
+    // Appends the first count bits of source (bit i of source[i / 64]), a word at a
+    // time. Bits past count in the last source word are ignored
+    void append(const uint64_t *source, int count);
+
+    // Removes the bit and shifts everything after it down by one
+    void erase(int index);
+
+    // Index of the first set bit at or after from, size() if there is none
+    int nextSet(int from) const;
+
+    // Number of set bits
+    int count() const;
+    bool all() const;
+    bool none() const;
+
+    Bitmap& operator&=(const Bitmap &rhs);
+    Bitmap& operator|=(const Bitmap &rhs);
+
+    const vector<uint64_t>& data() const;
+
+    static constexpr int WORD_BITS = 64;
+
+  private:
+    vector<uint64_t> words;
+    int bits = 0;
+
+    void clearTail();
+};
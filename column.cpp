@@ -1,999 +1,1803 @@
-#pragma once
-#include "datatypes.h"
-#include "column.h"
-
-using namespace std;
-
-/////////////////////////// Column //////////////////////////////////////
-Column::operator vector<Types> () const {
-  return col;
-}
-
-// Supports 2 indices: regular indexing, and pythonic negative indexing
-const Types& Column::operator[] (int index) const {
-  if (abs(index) > size()){
-    cerr << "Index out of range" << endl;
-    exit(10);
-  }
-
-  if (index < 0){
-    return *(col.end() + index);
-  }
-
-  return *(col.begin() + index);
-}
-
-Types& Column::operator[] (int index) {
-  if (abs(index) > size()){
-    cerr << "Index out of range" << endl;
-    exit(10);
-  }
-
-  if (index < 0){
-    return *(col.end() + index);
-  }
-
-  return *(col.begin() + index);
-}
-
-////// Constructors
-Column::Column(const Datatypes Type) : type(Type) {
-  ColumnConstraints defaultParams;
-  unique = defaultParams.Unique;
-  takesNulls = defaultParams.TakesNulls;
-  isPrimaryKey = defaultParams.IsPrimaryKey;
-  isForeignKey = defaultParams.IsForeignKey;
-  defaultValue = defaultParams.DefaultValue;
-
-  timePrecision = defaultParams.TimePrecision;
-  charLength = defaultParams.CharLength;
-}
-
-Column::Column(const Datatypes Type, ColumnConstraints Constraints) : type(Type),
-  unique(Constraints.Unique), takesNulls(Constraints.TakesNulls), defaultValue(Constraints.DefaultValue),
-  timePrecision(Constraints.TimePrecision), charLength(Constraints.CharLength), 
-  isPrimaryKey(Constraints.IsPrimaryKey), isForeignKey(Constraints.IsForeignKey) {
-  
-  enforceCellContraint(defaultValue, true);    
-}
-
-Column::Column(const vector<Types> Column, const Datatypes Type) : col(Column), type(Type) {
-  ColumnConstraints defaultParams;
-  unique = defaultParams.Unique;
-  takesNulls = defaultParams.TakesNulls;
-  isPrimaryKey = defaultParams.IsPrimaryKey;
-  isForeignKey = defaultParams.IsForeignKey;
-  defaultValue = defaultParams.DefaultValue;
-
-  timePrecision = defaultParams.TimePrecision;
-  charLength = defaultParams.CharLength; 
-  
-  enforceWholeColumnConstraints();
-}
-
-Column::Column(const vector<Types> Column, const Datatypes Type, ColumnConstraints Constraints) :
-  type(Type), col(Column), unique(Constraints.Unique), takesNulls(Constraints.TakesNulls), 
-  defaultValue(Constraints.DefaultValue),timePrecision(Constraints.TimePrecision), 
-  charLength(Constraints.CharLength), isPrimaryKey(Constraints.IsPrimaryKey), isForeignKey(Constraints.IsForeignKey) {
-
-  enforceCellContraint(defaultValue, true);
-  enforceWholeColumnConstraints();
-}
-
-////// Basic column manipulation
-int Column::size() const {
-  return col.size();
-}
-
-void Column::push() {
-  col.push_back(defaultValue);
-}
-
-void Column::push(const Types value) {
-  enforceCellContraint(value);
-
-  col.push_back(value);
-}
-
-void Column::update(int index, const Types newValue) {
-  enforceCellContraint(newValue);
-
-  col[index] = newValue;
-}
-
-void Column::erase(int index) {
-  col.erase(col.begin() + index);
-}
-
-void Column::bulkErase(vector<int> &indices) {
-  // Sorting from greatest to smallest prevents any 'moved indices' shenanigans
-  sort(indices.begin(), indices.end(), std::greater<Types>());
-
-  for (int i : indices) {
-    col.erase(col.begin() + i);
-  }
-}
-
-void Column::bulkUpdate(vector<int> &indices, const Types newValue) {
-  enforceCellContraint(newValue);
-
-  for (int i : indices) {
-    col[i] = newValue;
-  }
-
-  enforceWholeColumnConstraints();
-}
-
-
-
-////// Temporary column creation functions
-// Does not do type checking, will error if given a non-decimal column
-Column Column::round(const vector<int> &indices, int decimals) const {
-  Column converted(Datatypes::FLOAT); //we round to certain decimals, so needs to be float
-  float mult = pow(10, decimals);
-  
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else if (isString(type) || isNumeric(type)){
-      converted.push(
-        std::roundf(getNumeric<float>(col[i]) * mult ) / mult 
-      );
-    }
-    else {
-      converted.push(col[i]);
-    }
-  }
-
-  return converted;
-}
-
-// Does not do type checking. Will attempt to work with a string type
-Column Column::ceiling(const vector<int> &indices) const {
-  Column converted(Datatypes::BIGINT); 
-
-  for (int i: indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else if (isNumeric(type) || isString(type)){
-      int64_t ceiled = (int64_t)std::ceil(getNumeric<float>(col[i]));
-      converted.push(ceiled);
-    }
-    else {
-      converted.push(col[i]);
-    }
-  }
-
-  return converted;
-}
-
-Column Column::floor(const vector<int> &indices) const {
-  Column converted(Datatypes::BIGINT);
-
-  for (int i : indices){
-    if (isNull(col[i])) {
-      converted.push(Null);
-    }
-    else if (isNumeric(type) || isString(type)){
-      int64_t floored = (int64_t)std::floor(getNumeric<float>(col[i]));
-      
-      converted.push(floored);
-    }
-    else{
-      converted.push(col[i]);
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly with numeric types
-Column Column::absolute(const vector<int> &indices) const {
-  if (!isNumeric(type)){
-    cerr << "Column is not numeric" << endl;
-    exit(9);
-  }
-
-  Column converted(Datatypes::FLOAT);
-
-  for (int i : indices){
-    if (isNull(col[i])) {
-      converted.push(Null);
-    }
-    else{
-      converted.push((float)abs(getNumeric<float>(col[i])));
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly with string types
-Column Column::length(const vector<int> &indices) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);
-  }
-
-  Column converted(Datatypes::INT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      converted.push((int)getString(col[i]).length());
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly with string types
-Column Column::concat(const vector<int> &indices, string toConcatenate) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);
-  }
-  
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      converted.push(getString(col[i]) + toConcatenate);
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly with string types
-Column Column::upper(const vector<int> &indices) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);
-  }
-
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      string text = getString(col[i]);
-
-      for (char &c : text) {c = 'a' <= c && c <= 'z' ? c + ('A' - 'a') : c;}
-
-      converted.push(text);
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly with string types
-Column Column::lower(const vector<int> &indices) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);
-  }
-
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      string text = getString(col[i]);
-
-      for (char &c : text) {c = 'A' <= c && c <= 'Z' ? c + ('a' - 'A') : c;}
-
-      converted.push(text);
-    }
-  }
-
-  return converted;
-} 
-
-// Works strictly with string types
-Column Column::initCap(const vector<int> &indices) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);
-  }
-
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-
-    else{
-      string text = getString(col[i]);
-
-      if (text.empty()){
-        converted.push(text);
-        continue;
-      }
-
-      bool pastWasDelimiter = true;
-      auto isDelimiter = [] (char c) -> bool {
-        return (!('A' <= c && c <= 'Z') &&
-                !('a' <= c && c <= 'z') &&
-                !('0' <= c && c <= '9'));
-      };
-
-      for (char &c : text) {
-        if (isDelimiter(c)){
-          pastWasDelimiter = true;
-          continue;
-        }
-        
-        if ('0' <= c && c <= '9'){
-          pastWasDelimiter = false;
-          continue;
-        }
-
-        c = pastWasDelimiter ? static_cast<char>(std::toupper(c)) :
-                               static_cast<char>(std::tolower(c));
-        pastWasDelimiter = false;
-      }
-      
-      converted.push(text);
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly on strings. startPos is 1-indexed!
-Column Column::substring(const vector<int> &indices, int startPos, int length) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);
-  }
-  
-  Column converted(Datatypes::TEXT);
-  --startPos;
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      string text = getString(col[i]);
-      
-      if (startPos < 0) startPos = 0;
-
-      if (static_cast<int>(text.size()) < startPos){
-        converted.push("");
-        continue;
-      }
-
-      converted.push(text.substr(startPos, std::min(startPos + length, (int)text.size()) - startPos));
-    }
-  }
-
-  return converted;
-}
-
-// Works strictly on string types
-Column Column::trim(const vector<int> &indices, 
-                    const TrimModes mode, char toRemove) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);    
-  }
-
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-      continue;
-    }
-
-    string text = getString(col[i]);
-
-    switch (mode){
-      case TrimModes::LEADING: {
-        auto cut = text.begin();
-        while (cut != text.end() && *cut == toRemove){
-          ++cut;
-        }
-
-        converted.push(string(cut, text.end()));
-        break;
-      }
-
-      case TrimModes::TRAILING: {
-        auto cut = text.rbegin();
-        while (cut != text.rend() && *cut == toRemove){
-          ++cut;
-        }
-
-        converted.push(string(text.begin(), cut.base()));
-        break;
-      }
-
-      case TrimModes::BOTH: {
-        auto bcut = text.begin();
-        while (bcut != text.end() && *bcut == toRemove){
-          ++bcut;
-        }
-
-        text = string(bcut, text.end());
-
-        auto ecut = text.rbegin();
-        while (ecut != text.rend() && *ecut == toRemove){
-          ++ecut;
-        }
-
-        converted.push(string(text.begin(), ecut.base()));
-        break;
-      }
-    } // Switch statement
-  } // For loop
-
-  return converted;
-}
-
-// Works strictly on string types
-Column Column::replace(const vector<int> &indices, 
-                       const string &substr, const string &newVal) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);    
-  }
-
-  Column converted(Datatypes::TEXT);  
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-      continue;
-    }
-
-    string text = getString(col[i]);
-
-    // Bug: there can be a case where a conversion generates extra cases of what needs 
-    // to be replaced, thereby deleting extra information
-    size_t start = text.find(substr, 0);
-    
-    while (start != std::string::npos){
-      text.replace(start, substr.size(), newVal);
-      start = text.find(substr, 0);
-    }
-
-    converted.push(text);
-  }
-
-  return converted;
-}
-
-Column Column::left(const vector<int> &indices, int cutoff) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);    
-  }
-  
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      string text = getString(col[i]);
-
-      if (cutoff > text.size()){
-        converted.push(text);
-        continue;
-      }
-
-      converted.push(string(text.begin(), text.begin() + cutoff));
-    }
-  }
-
-  return converted;
-}
-
-Column Column::right(const vector<int> &indices, int start) const {
-  if (!isString(type)){
-    cerr << "Column is not string based" << endl;
-    exit(9);    
-  }
-  
-  Column converted(Datatypes::TEXT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      string text = getString(col[i]);
-
-      if (start > text.size()){
-        converted.push("");
-        continue;
-      }
-
-      converted.push(string(text.begin(), (text.rbegin() + start).base()));
-    }
-  }
-
-  return converted;
-}
-
-template <typename Component>
-std::enable_if_t<is_same_v<decay_t<Component>, DateComponents> 
-              || is_same_v<decay_t<Component>, TimeComponents>
-              , Column> 
-Column::extract(const vector<int> &indices, const Component &mode) const {
-  if (!isDate(type)){
-    cerr << "Column is not date based" << endl;
-    exit(9);
-  }
-
-  Column converted(Datatypes::FLOAT);
-
-  for (int i : indices){
-    if (isNull(col[i])){
-      converted.push(Null);
-    }
-    else{
-      float component = std::visit([&mode] (auto &value) {
-        return static_cast<float>(value.extract(mode));
-      }, col[i]);
-
-      converted.push(component);
-    }
-  }
-
-  return converted;
-}
-
-Column Column::nullIf(const vector<int> &indices, const Types &rhs) const {
-  Column converted(type, {unique, true, isPrimaryKey, isForeignKey, 
-                          defaultValue, timePrecision, charLength});
-
-  for (int i : indices){
-    bool areEqual = std::visit([] (auto &lhs, auto &rhs) -> bool {
-      using lhsT = decay_t<decltype(lhs)>;
-      using rhsT = decay_t<decltype(rhs)>;
-
-      if constexpr (is_same_v<lhsT, rhsT> || (is_arithmetic_v<lhsT> && is_arithmetic_v<rhsT>) ||
-                    (is_string_v<lhsT> && is_string_v<rhsT>)){
-        return lhs == rhs;
-      }
-      
-      return false;
-    }, col[i], rhs);
-
-    if (areEqual) converted.push(Null);
-    else converted.push(col[i]);
-  }
-
-  return converted;
-}
-
-Column Column::coalesce(const vector<int> &indices, const Types &rhs) const {
-  Column converted(type, {unique, false, isPrimaryKey, isForeignKey, 
-                          validNonNullDefaultValue(type), timePrecision, charLength});  
-
-  for (int i : indices) {
-    if (isNull(col[i])){
-      converted.push(rhs);
-    }
-    else{
-      converted.push(col[i]);
-    }
-  }
-
-  return converted;
-}
-
-double Column::sum(const vector<int> &indices) const {
-  double total = 0;
-  
-  for (int i : indices){ //ugly af, shoudl be abstracted into a function
-    if (isNull(col[i])) continue;
-    
-    total += getNumeric<double>(col[i]);
-  }
-
-  return total;
-}
-
-double Column::sumDistinct(const vector<int> &indices) const { 
-  double total = 0;
-  set<double> seenNumbers; // This is a sum, so we can safely assume that we have a number
-
-  for (int i : indices) {
-    if (isNull(col[i])) continue;
-
-    double value = getNumeric<double>(col[i]);
-
-    if (seenNumbers.contains(value)) continue;
-
-    seenNumbers.insert(value);
-    total += value;
-  }
-
-  return total;
-}
-
-int Column::count(const vector<int> &indices) const {
-  int total = 0;
-  for (int i : indices) {
-    if (isNull(col[i])) continue;
-
-    ++total;
-  }
-
-  return total;
-}
-
-int Column::countDistinct(const vector<int> &indices) const {
-  int total = 0;
-  set<Types> seenValues;
-  for (int i : indices){
-    if (isNull(col[i]) || seenValues.contains(col[i])) continue;
-
-    seenValues.insert(col[i]);
-    ++total;
-  }
-
-  return total;
-}
-
-// Both can be made from O(2N) to O(N) by reqriting them, but this is cleaner
-double Column::avg(const vector<int> &indices) const {
-  return sum(indices) / (double)count(indices);
-}
-
-double Column::avgDistinct(const vector<int> &indices) const {
-  return sumDistinct(indices) / (double)countDistinct(indices);
-}
-
-// Cannot be done simply due to the fact that these are Types and need to be unpacked individually
-double Column::max(const vector<int> &indices) const {
-  double max = std::numeric_limits<double>::lowest();
-
-  for (int i : indices){
-    if (isNull(col[i])) continue;
-
-    max = std::max(max, (getNumeric<double>(col[i])));
-  }
-
-  return max;
-}
-
-double Column::min(const vector<int> &indices) const {
-  double min = std::numeric_limits<double>::max();
-
-  for (int i : indices){
-    if (isNull(col[i])) continue;
-
-    min = std::min(min, (getNumeric<double>(col[i])));
-  }
-
-  return min;
-}
-
-string Column::stringAggregate(const vector<int> &indices, string separator) const {
-  string result = "";
-
-  for (int i : indices){
-    if (isNull(col[i])) continue;
-    ostringstream stringHolder;
-    stringHolder << col[i];
-
-    result += stringHolder.str();
-    result += separator;
-  }
-
-  result.resize(result.size() - separator.size());
-  return result;
-}
-
-// sqrt(sigma((xi - avg)^2 / N))
-// Does not do type checking. will attempt to convert strings to numbers
-double Column::standardDeviation(const vector<int> &indices) const {
-  float average = (float)avg(indices);
-  int N = count(indices);
-
-  double stddev = 0;
-
-  for (int i : indices) {
-    stddev += pow(getNumeric<float>(col[i]) - average, 2);
-  }
-
-  stddev /= N;
-
-  return stddev;  
-}
-
-////// Private methods
-void Column::enforceCellContraint(const Types &cell, const bool comesFromBulk) const {
-  // Data type check
-  if (getType(cell) != type && getType(cell) != Datatypes::NULLVALUE){
-    cerr << "Datatype does not match the type of column" << endl;
-    exit(5);
-  }
-  
-  // Uniqueness (when coming in after the column has been created)
-  if (unique && !comesFromBulk && cell != Null && find(col.begin(), col.end(), cell) != col.end()){
-    cerr << "Uniqueness constraint not met" << endl;
-    exit(5);
-  }
-
-  // Takes nulls 
-  if (isNull(cell) && !takesNulls){
-    cerr << "(Does not take) Nulls constraint not met" << endl;
-    exit(5);
-  }
-
-  // Time Precision
-  if (holds_alternative<Time>(cell) && timePrecision != -1 && get<Time>(cell).precision != timePrecision) {
-    cerr << "Time precision constraint not met" << endl;
-    exit(5);
-  }
-
-  if (holds_alternative<Datetime>(cell) && timePrecision != -1 && get<Datetime>(cell).time.precision != timePrecision) {
-    cerr << "Time precision constraint not met" << endl;
-    exit(5);
-  }
-
-  // CharLength Precision
-  if (holds_alternative<Varchar>(cell) && charLength != -1 && get<Varchar>(cell).length != charLength) {
-    cerr << "Char length constraint not met" << endl;
-    exit(5);
-  }
-
-  if (holds_alternative<SQLChar>(cell) && charLength != -1 && get<SQLChar>(cell).length != charLength) {
-    cerr << "Char length constraint not met" << endl;
-    exit(5);
-  }
-}
-
-void Column::enforceWholeColumnConstraints() const {
-  for (Types cell : col){
-    enforceCellContraint(cell, true);
-  }
-
-  // Uniqueness must be enforced here. Since we supoprt instantiating this object
-  // with a vector, we must check this independently
-  if (!unique) return;
-
-  set<Types> uniqueCol(col.begin(), col.end());
-  if (uniqueCol.size() != col.size()) {
-    cerr << "Uniqueness constraint not met" << endl;
-    exit(5);
-  }
-}
-
-Types validNonNullDefaultValue(Datatypes type) {
-  switch (type) {
-    case (Datatypes::BIGINT): {
-      return static_cast<int64_t>(0);
-    } 
-    case (Datatypes::BOOL): {
-      return false;
-    }
-    case (Datatypes::CHAR): {
-      return SQLChar();
-    }
-    case (Datatypes::DATE): {
-      return Date("2000-01-01");
-    }
-    case (Datatypes::DATETIME): {
-      return Datetime();
-    }
-    case (Datatypes::FLOAT): {
-      return static_cast<float>(0);
-    }
-    case (Datatypes::INT): {
-      return static_cast<int>(0);
-    }
-    case (Datatypes::SMALLINT): {
-      return static_cast<int16_t>(0);
-    }
-    case (Datatypes::TEXT): {
-      return "";
-    }
-    case (Datatypes::TIME): {
-      return Time();
-    }
-    case (Datatypes::VARCHAR): {
-      return Varchar();
-    }
-  }
-}
-
-///////////////////////////// Column end ////////////////////////////////
-
-
-
-
-
-
-
-
-
-
-
-
-
-////////////////////////////// Table start ///////////////////////////////
-
-// // Public
-
-// Table::Table() {}
-
-// // Add a new column to the table
-// // Ensures the datatype is supported
-// void Table::insertColumn(const string name, const string dataType){    
-//   assert(validDatatype(dataType));
-
-//   columns[name] = {};
-//   columnNames.push_back(name);
-
-//   ++numCols;
-
-//   // Populate the column with nulls for the number of rows in table
-//   for (int i = 0; i < numRows; ++i){
-//     columns[name].push_back(Null);
-//   }
-// }
-
-// // Add a new char/varchar column to the table
-// void Table::insertColumn(const string name, const string dataType, const int length){    
-//   assert(dataType == "CHAR" || dataType == "VARCHAR");
-
-//   columns[name] = {};
-//   columnNames.push_back(name);
-//   charTypeColumnLengths[name] = length;
-
-//   ++numCols;
-
-//   // Populate the column with nulls for the number of rows in table
-//   for (int i = 0; i < numRows; ++i){
-//     columns[name].push_back(Null);
-//   }
-// }
-
-// // Add a new row to the table
-// // Skips incorrectly names/non-existent columns
-// // Columns not specified get initialized as NULL
-// void Table::insertRow(Row row){
-//   for (string column : columnNames){
-//     if (row.find(column) == row.end()) row[column] = Null;
-
-//     columns[column].push_back(row[column]);
-//   }
-
-//   order.push_back(numRows);
-//   ++numRows;
-// }
-
-
-// int Table::getCharTypeLength(const string name) const {
-//   assert(columnNameExists(name));
-
-//   return charTypeColumnLengths.at(name);
-// }
-
-// // Prints out the existing SQL table
-// void Table::print() {
-//   tableValidityCheck();
-//   bool hadToCutOutValue = 0;
-//   string delimiter = " | ", numHeader = "#   ";
-
-//   // Header
-//   cout << numHeader;
-
-//   unordered_map<string, int> width;
-//   int totalSize = numHeader.size();
-//   for (string name : columnNames){
-//     width[name] = name.size();
-//     totalSize += name.size();
-//     cout << delimiter << name;
-//   }
-//   cout << "\n";
-
-//   // Separator
-//   string separator(totalSize, '='); // Why is - not monospace...
-//   cout << separator << "\n";
-
-//   // Rows, in order
-//   for (int i : order){
-//     int length = numHeader.size() - to_string(i).size();
-//     string whitespace(length, ' ');
-//     cout << i << whitespace;
-
-//     for (string name : columnNames) {
-//       Types value = columns[name][i];
-      
-
-//       // Extract the value from the cell
-//       ostringstream os;
-//       os << value;
-//       string toPrint = os.str();
-
-//       length = width[name] - toPrint.size();
-//       if (length < 0) { // Edge case where value would not fit in col
-//         toPrint.resize(width[name]); 
-//         length = 0;
-//         hadToCutOutValue = true;
-//       }
-
-//       string whitespace(length, ' ');
-//       cout << delimiter << toPrint << whitespace;
-
-//     }
-
-//     cout << "\n";
-
-//   }
-
-//   if (hadToCutOutValue){
-//     cout << "\nWARNING: Had to cut out some values since they did not fit\nConsider making your column names longer\n";
-//   }
-// }
-  
-// // Private
-
-// // General validity checks
-
-// bool Table::validDatatype(const string datatype) const {
-//   for (string valid : supportedDatatypes){
-//     if (datatype == valid) return true;
-//   }
-
-//   return false;
-// }
-
-// bool Table::columnNameExists(string const name) const {
-//   return find(columnNames.begin(), columnNames.end(), name) != columnNames.end();
-// }
-
-// // TODO: two way check: all columns in table are in columnNames,
-// // all columnNames columns exist
-// void Table::columnNameValidityCheck(){
-//   for (string name : columnNames){
-//     if (columns.find(name) == columns.end()){
-//       cerr << "Column " << name << " found in columnNames but not in columns" << endl;
-//       exit(1);
-//     }
-//   }
-
-//   if (columnNames.size() != columns.size()){
-//     cerr << "mismatch between the number of elements in columns and columnNames" << endl;
-//     exit(1);
-//   }
-// }
-    
-// void Table::tableValidityCheck() {
-//   if (numCols != columns.size()) {
-//     cerr << "numCols and actual number of columns missaligned" << endl;
-//     exit(1);
-//   }
-
-//   for (string name : columnNames) {
-//     if (numRows != columns[name].size()) {
-//       cerr << "numRows and actual number of entries missaligned in " << name << endl;
-//       exit(1);
-//     }
-//   }
-
-// }
-
+#pragma once
+#include "datatypes.h"
+#include "column.h"
+
+using namespace std;
+
+/////////////////////////// Column //////////////////////////////////////
+Column::operator vector<Types> () const {
+  vector<Types> cells;
+  cells.reserve(size());
+
+  for (int i = 0; i < size(); ++i){
+    cells.push_back(storage.get(i));
+  }
+
+  return cells;
+}
+
+// Supports 2 indices: regular indexing, and pythonic negative indexing
+Types Column::operator[] (int index) const {
+  if (abs(index) > size()){
+    cerr << "Index out of range" << endl;
+    exit(10);
+  }
+
+  if (index < 0){
+    return storage.get(size() + index);
+  }
+
+  return storage.get(index);
+}
+
+////// Constructors
+Column::Column(const Datatypes Type) : type(Type), storage(Type) {
+  ColumnConstraints defaultParams;
+  unique = defaultParams.Unique;
+  takesNulls = defaultParams.TakesNulls;
+  isPrimaryKey = defaultParams.IsPrimaryKey;
+  isForeignKey = defaultParams.IsForeignKey;
+  defaultValue = defaultParams.DefaultValue;
+
+  timePrecision = defaultParams.TimePrecision;
+  charLength = defaultParams.CharLength;
+}
+
+Column::Column(const Datatypes Type, ColumnConstraints Constraints) : type(Type),
+  unique(Constraints.Unique), takesNulls(Constraints.TakesNulls), defaultValue(Constraints.DefaultValue),
+  timePrecision(Constraints.TimePrecision), charLength(Constraints.CharLength), 
+  isPrimaryKey(Constraints.IsPrimaryKey), isForeignKey(Constraints.IsForeignKey),
+  dictionaryEncoded(Constraints.DictionaryEncoded), 
+  storage(Type, Constraints.DictionaryEncoded, Constraints.TimePrecision, Constraints.CharLength, 
+          Constraints.SegmentRows) {
+  
+  enforceCellContraint(defaultValue, true);    
+}
+
+Column::Column(const vector<Types> Column, const Datatypes Type) : type(Type), storage(Type) {
+  ColumnConstraints defaultParams;
+  unique = defaultParams.Unique;
+  takesNulls = defaultParams.TakesNulls;
+  isPrimaryKey = defaultParams.IsPrimaryKey;
+  isForeignKey = defaultParams.IsForeignKey;
+  defaultValue = defaultParams.DefaultValue;
+
+  timePrecision = defaultParams.TimePrecision;
+  charLength = defaultParams.CharLength; 
+
+  storage.reserve(Column.size());
+  for (const Types &cell : Column){
+    storage.push(cell);
+  }
+  
+  enforceWholeColumnConstraints();
+}
+
+Column::Column(const vector<Types> Column, const Datatypes Type, ColumnConstraints Constraints) :
+  type(Type), unique(Constraints.Unique), takesNulls(Constraints.TakesNulls), 
+  defaultValue(Constraints.DefaultValue),timePrecision(Constraints.TimePrecision), 
+  charLength(Constraints.CharLength), isPrimaryKey(Constraints.IsPrimaryKey), isForeignKey(Constraints.IsForeignKey),
+  dictionaryEncoded(Constraints.DictionaryEncoded), 
+  storage(Type, Constraints.DictionaryEncoded, Constraints.TimePrecision, Constraints.CharLength, 
+          Constraints.SegmentRows) {
+
+  enforceCellContraint(defaultValue, true);
+
+  storage.reserve(Column.size());
+  for (const Types &cell : Column){
+    storage.push(cell);
+  }
+
+  enforceWholeColumnConstraints();
+}
+
+////// Basic column manipulation
+int Column::size() const {
+  return storage.size();
+}
+
+void Column::push() {
+  storage.push(defaultValue);
+}
+
+void Column::push(const Types value) {
+  enforceCellContraint(value);
+
+  storage.push(value);
+}
+
+bool Column::pushField(string_view field) {
+  if (field.empty() || field == "NULL") {
+    enforceCellContraint(Null, true);
+    storage.push(Null);
+    return true;
+  }
+
+  int64_t integer;
+  float real;
+  bool boolean;
+  int32_t epoch;
+  int64_t micros;
+  const int precision = timePrecision == -1 ? 6 : timePrecision;
+
+  switch (type) {
+    case Datatypes::BOOL:
+      if (!parseBool(field, boolean)) return false;
+      storage.push(boolean);
+      return true;
+
+    case Datatypes::SMALLINT:
+      if (!parseInteger(field, integer, 16)) return false;
+      storage.push(static_cast<int16_t>(integer));
+      return true;
+
+    case Datatypes::INT:
+      if (!parseInteger(field, integer, 32)) return false;
+      storage.push(static_cast<int>(integer));
+      return true;
+
+    case Datatypes::BIGINT:
+      if (!parseInteger(field, integer)) return false;
+      storage.push(integer);
+      return true;
+
+    case Datatypes::FLOAT:
+      if (!parseFloat(field, real)) return false;
+      storage.push(real);
+      return true;
+
+    case Datatypes::DATE:
+      if (!parseIsoDate(field, epoch)) return false;
+      storage.pushPacked(epoch);
+      return true;
+
+    case Datatypes::TIME:
+      if (!parseIsoTime(field, micros, precision)) return false;
+      storage.pushPacked(micros);
+      return true;
+
+    case Datatypes::DATETIME:
+      if (!parseIsoDatetime(field, micros, precision)) return false;
+      storage.pushPacked(micros);
+      return true;
+
+    default:
+      break;
+  }
+
+  // Strings. CHAR cells don't keep their padding
+  if (type == Datatypes::CHAR) {
+    size_t end = field.find_last_not_of(' ');
+    field = field.substr(0, end == string_view::npos ? 0 : end + 1);
+  }
+
+  if (charLength != -1 && static_cast<int>(field.size()) > charLength) {
+    cerr << "Char length constraint not met" << endl;
+    exit(5);
+  }
+
+  // Dictionary cells carry the column's declared length, as CharArena gives its cells
+  if (dictionaryEncoded && type != Datatypes::TEXT) {
+    string value(field);
+    int length = charLength == -1 ? value.size() : charLength;
+
+    storage.push(type == Datatypes::CHAR ? Types(SQLChar(length, value)) : Types(Varchar(length, value)));
+  }
+  else {
+    storage.pushString(field);
+  }
+
+  return true;
+}
+
+void Column::update(int index, const Types newValue) {
+  enforceCellContraint(newValue);
+
+  storage.set(index, newValue);
+}
+
+void Column::pop() {
+  storage.pop();
+}
+
+void Column::erase(int index) {
+  storage.erase(index);
+}
+
+void Column::bulkErase(vector<int> &indices) {
+  // Sorting from greatest to smallest prevents any 'moved indices' shenanigans
+  sort(indices.begin(), indices.end(), std::greater<Types>());
+
+  for (int i : indices) {
+    storage.erase(i);
+  }
+}
+
+void Column::bulkUpdate(vector<int> &indices, const Types newValue) {
+  enforceCellContraint(newValue);
+
+  for (int i : indices) {
+    storage.set(i, newValue);
+  }
+
+  enforceWholeColumnConstraints();
+}
+
+// Text of a dictionary entry. CHAR entries are stored unpadded, as in the arenas
+template <typename Entry>
+string_view entryView(const Entry &entry) {
+  if constexpr (is_same_v<Entry, string>) return entry;
+  else return entry.value;
+}
+
+////// Pattern matching
+// Works strictly on string types. Rows whose text matches(text) accepts are selected,
+// NULL rows never are
+template <typename Predicate>
+Selection Column::rowsMatching(Predicate matches) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  Bitmap goodIndices;
+  goodIndices.reserve(size());
+
+  storage.forEachSegment([&] (const ColumnSegment &segment, int) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+
+      if constexpr (is_dictionary_v<Buffer>) {
+        vector<uint8_t> entryMatches;
+        for (const auto &entry : buffer.getEntries()) entryMatches.push_back(matches(entryView(entry)));
+
+        const vector<int> &codes = buffer.getCodes();
+        for (int i = 0; i < buffer.size(); ++i) {
+          goodIndices.push(!segment.isNull(i) && entryMatches[codes[i]]);
+        }
+      }
+      else {
+        for (int i = 0; i < segment.size(); ++i) {
+          goodIndices.push(!segment.isNull(i) && matches(segment.getStringView(i)));
+        }
+      }
+    });
+  });
+
+  return Selection::adaptive(std::move(goodIndices));
+}
+
+Selection Column::like(const string &pattern, const char escape) const {
+  LikePattern compiled(pattern, false, escape);
+  return rowsMatching([&compiled] (string_view text) {return compiled.matches(text);});
+}
+
+Selection Column::ilike(const string &pattern, const char escape) const {
+  LikePattern compiled(pattern, true, escape);
+  return rowsMatching([&compiled] (string_view text) {return compiled.matches(text);});
+}
+
+Selection Column::notLike(const string &pattern, const char escape) const {
+  LikePattern compiled(pattern, false, escape);
+  return rowsMatching([&compiled] (string_view text) {return !compiled.matches(text);});
+}
+
+Selection Column::notIlike(const string &pattern, const char escape) const {
+  LikePattern compiled(pattern, true, escape);
+  return rowsMatching([&compiled] (string_view text) {return !compiled.matches(text);});
+}
+
+Selection Column::regexpLike(const string &pattern, const bool caseInsensitive) const {
+  shared_ptr<Regex> regex = Regex::compiled(pattern, caseInsensitive);
+  return rowsMatching([&regex] (string_view text) {return regex->search(text);});
+}
+
+////// Temporary column creation functions
+// Does not do type checking, will error if given a non-decimal column
+Column Column::round(const Selection &indices, int decimals) const {
+  Column converted(Datatypes::FLOAT); //we round to certain decimals, so needs to be float
+  float mult = pow(10, decimals);
+  
+  indices.forEach([&] (int i) {
+    if (storage.isNull(i)){
+      converted.push(Null);
+    }
+    else if (isString(type) || isNumeric(type)){
+      converted.push(
+        std::roundf(storage.getNumeric<float>(i) * mult ) / mult 
+      );
+    }
+    else {
+      converted.push(storage.get(i));
+    }
+  });
+
+  return converted;
+}
+
+// Does not do type checking. Will attempt to work with a string type
+Column Column::ceiling(const Selection &indices) const {
+  Column converted(Datatypes::BIGINT); 
+
+  indices.forEach([&] (int i) {
+    if (storage.isNull(i)){
+      converted.push(Null);
+    }
+    else if (isNumeric(type) || isString(type)){
+      int64_t ceiled = (int64_t)std::ceil(storage.getNumeric<float>(i));
+      converted.push(ceiled);
+    }
+    else {
+      converted.push(storage.get(i));
+    }
+  });
+
+  return converted;
+}
+
+Column Column::floor(const Selection &indices) const {
+  Column converted(Datatypes::BIGINT);
+
+  indices.forEach([&] (int i) {
+    if (storage.isNull(i)) {
+      converted.push(Null);
+    }
+    else if (isNumeric(type) || isString(type)){
+      int64_t floored = (int64_t)std::floor(storage.getNumeric<float>(i));
+      
+      converted.push(floored);
+    }
+    else{
+      converted.push(storage.get(i));
+    }
+  });
+
+  return converted;
+}
+
+// Works strictly with numeric types
+Column Column::absolute(const Selection &indices) const {
+  if (!isNumeric(type)){
+    cerr << "Column is not numeric" << endl;
+    exit(9);
+  }
+
+  Column converted(Datatypes::FLOAT);
+
+  indices.forEach([&] (int i) {
+    if (storage.isNull(i)) {
+      converted.push(Null);
+    }
+    else{
+      converted.push((float)abs(storage.getNumeric<float>(i)));
+    }
+  });
+
+  return converted;
+}
+
+// Works strictly with string types
+Column Column::length(const Selection &indices) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);
+  }
+
+  Column converted(Datatypes::INT);
+
+  indices.forEach([&] (int i) {
+    if (storage.isNull(i)){
+      converted.push(Null);
+    }
+    else{
+      converted.push((int)storage.getStringView(i).length());
+    }
+  });
+
+  return converted;
+}
+
+// Applies transform to every non null string in indices. transform appends its
+// result to out, a scratch string reused across rows, which is then copied into
+// the result's arena, so no row allocates. Dictionary encoded columns only run
+// it once per distinct value, and the result keeps the encoding
+template <typename Transform>
+Column Column::transformStrings(const Selection &indices, Transform transform) const {
+  ColumnConstraints constraints;
+  constraints.DictionaryEncoded = dictionaryEncoded;
+
+  Column converted(Datatypes::TEXT, constraints);
+  converted.storage.reserve(indices.size());
+
+  string out;
+
+  // Dictionary entries are transformed once per segment, and only redone when
+  // the runs move on to another segment
+  const ColumnSegment *transformedSegment = nullptr;
+  vector<string> transformed;
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+
+      if constexpr (is_dictionary_v<Buffer>) {
+        if (transformedSegment != &segment) {
+          transformedSegment = &segment;
+          transformed.clear();
+
+          for (const auto &entry : buffer.getEntries()) {
+            out.clear();
+            transform(entryView(entry), out);
+            transformed.push_back(out);
+          }
+        }
+
+        const vector<int> &codes = buffer.getCodes();
+        for (int i : run){
+          if (segment.isNull(i - start)) converted.storage.push(Null);
+          else converted.storage.pushString(transformed[codes[i - start]]);
+        }
+      }
+      else {
+        for (int i : run){
+          if (segment.isNull(i - start)) {
+            converted.storage.push(Null);
+            continue;
+          }
+
+          out.clear();
+          transform(segment.getStringView(i - start), out);
+          converted.storage.pushString(out);
+        }
+      }
+    });
+  });
+
+  return converted;
+}
+
+// Same as transformStrings, for kernels that rewrite bytes in place without changing
+// lengths. Each run's strings are gathered into one buffer, NUL separated so words
+// never span two rows, and kernel(bytes, count) goes over all of it in one call.
+// The cells go straight into the result's storage, with no constraint checks
+template <typename Kernel>
+Column Column::transformBytes(const Selection &indices, Kernel kernel) const {
+  ColumnConstraints constraints;
+  constraints.DictionaryEncoded = dictionaryEncoded;
+
+  Column converted(Datatypes::TEXT, constraints);
+  converted.storage.reserve(indices.size());
+
+  string bytes;
+  vector<int> ends; // Where each row's bytes end, -1 for NULL
+
+  const ColumnSegment *transformedSegment = nullptr;
+  vector<string> transformed;
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+
+      if constexpr (is_dictionary_v<Buffer>) {
+        if (transformedSegment != &segment) {
+          transformedSegment = &segment;
+          transformed.clear();
+
+          for (const auto &entry : buffer.getEntries()) {
+            transformed.emplace_back(entryView(entry));
+            kernel(transformed.back().data(), transformed.back().size());
+          }
+        }
+
+        const vector<int> &codes = buffer.getCodes();
+        for (int i : run){
+          if (segment.isNull(i - start)) converted.storage.push(Null);
+          else converted.storage.pushString(transformed[codes[i - start]]);
+        }
+      }
+      else {
+        bytes.clear();
+        ends.clear();
+
+        for (int i : run){
+          if (segment.isNull(i - start)) {
+            ends.push_back(-1);
+            continue;
+          }
+
+          bytes.append(segment.getStringView(i - start));
+          ends.push_back(bytes.size());
+          bytes.push_back('\0');
+        }
+
+        kernel(bytes.data(), bytes.size());
+
+        string_view all = bytes;
+        size_t begin = 0;
+
+        for (int end : ends) {
+          if (end < 0) {
+            converted.storage.push(Null);
+            continue;
+          }
+
+          converted.storage.pushString(all.substr(begin, end - begin));
+          begin = end + 1;
+        }
+      }
+    });
+  });
+
+  return converted;
+}
+
+// Works strictly with string types
+Column Column::concat(const Selection &indices, string toConcatenate) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);
+  }
+
+  return transformStrings(indices, [&toConcatenate] (string_view text, string &out) {
+    out.append(text);
+    out.append(toConcatenate);
+  });
+}
+
+// Works strictly with string types
+Column Column::upper(const Selection &indices) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);
+  }
+
+  return transformBytes(indices, asciiUpper);
+}
+
+// Works strictly with string types
+Column Column::lower(const Selection &indices) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);
+  }
+
+  return transformBytes(indices, asciiLower);
+} 
+
+// Works strictly with string types
+Column Column::initCap(const Selection &indices) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);
+  }
+
+  return transformBytes(indices, asciiInitCap);
+}
+
+// Works strictly on strings. startPos is 1-indexed!
+Column Column::substring(const Selection &indices, int startPos, int length) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);
+  }
+  
+  --startPos;
+  if (startPos < 0) startPos = 0;
+
+  return transformStrings(indices, [startPos, length] (string_view text, string &out) {
+    if (static_cast<int>(text.size()) < startPos) return;
+
+    out.append(text.substr(startPos, std::min(startPos + length, (int)text.size()) - startPos));
+  });
+}
+
+// Works strictly on string types
+Column Column::trim(const Selection &indices, 
+                    const TrimModes mode, char toRemove) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  return transformStrings(indices, [mode, toRemove] (string_view text, string &out) {
+    size_t begin = 0;
+    size_t end = text.size();
+
+    if (mode == TrimModes::LEADING || mode == TrimModes::BOTH) {
+      while (begin != end && text[begin] == toRemove){
+        ++begin;
+      }
+    }
+
+    if (mode == TrimModes::TRAILING || mode == TrimModes::BOTH) {
+      while (end != begin && text[end - 1] == toRemove){
+        --end;
+      }
+    }
+
+    out.append(text.substr(begin, end - begin));
+  });
+}
+
+// Works strictly on string types
+Column Column::replace(const Selection &indices, 
+                       const string &substr, const string &newVal) const {
+  return replace(indices, {{substr, newVal}});
+}
+
+// Works strictly on string types. Every row is streamed once into the output, and
+// what was put in is never scanned again
+Column Column::replace(const Selection &indices, const vector<pair<string, string>> &replacements) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  vector<string> patterns;
+  for (const auto &replacement : replacements) patterns.push_back(replacement.first);
+
+  AhoCorasick matcher(patterns);
+
+  return transformStrings(indices, [&matcher, &replacements] (string_view text, string &out) {
+    size_t copied = 0;
+
+    matcher.forEachMatch(text, [&] (size_t start, int length, int pattern) {
+      out.append(text.substr(copied, start - copied));
+      out.append(replacements[pattern].second);
+      copied = start + length;
+    });
+
+    out.append(text.substr(copied));
+  });
+}
+
+// Works strictly on string types
+Column Column::translate(const Selection &indices, const string &from, const string &to) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  // What each byte becomes: KEEP, REMOVE, or the replacement byte
+  constexpr int KEEP = -1;
+  constexpr int REMOVE = -2;
+
+  array<int, 256> mapping;
+  mapping.fill(KEEP);
+
+  for (size_t i = 0; i < from.size(); ++i) {
+    int &target = mapping[static_cast<uint8_t>(from[i])];
+    if (target == KEEP) target = i < to.size() ? static_cast<uint8_t>(to[i]) : REMOVE;
+  }
+
+  return transformStrings(indices, [&mapping] (string_view text, string &out) {
+    for (char c : text) {
+      int target = mapping[static_cast<uint8_t>(c)];
+
+      if (target == KEEP) out.push_back(c);
+      else if (target != REMOVE) out.push_back(static_cast<char>(target));
+    }
+  });
+}
+
+// Works strictly on string types
+Column Column::regexpExtract(const Selection &indices, const string &pattern, const bool caseInsensitive) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  shared_ptr<Regex> regex = Regex::compiled(pattern, caseInsensitive);
+
+  return transformStrings(indices, [&regex] (string_view text, string &out) {
+    size_t start, length;
+    if (regex->find(text, 0, start, length)) out.append(text.substr(start, length));
+  });
+}
+
+// Works strictly on string types
+Column Column::regexpReplace(const Selection &indices, const string &pattern, 
+                             const string &replacement, const bool caseInsensitive) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  shared_ptr<Regex> regex = Regex::compiled(pattern, caseInsensitive);
+
+  // Where matches start is found for the whole row at once, instead of once per match
+  vector<bool> starts;
+
+  return transformStrings(indices, [&regex, &replacement, &starts] (string_view text, string &out) {
+    regex->matchStarts(text, starts);
+
+    size_t copied = 0;
+
+    for (size_t from = 0; ; ) {
+      size_t start = from;
+      while (start <= text.size() && !starts[start]) ++start;
+      if (start > text.size()) break;
+
+      size_t length = regex->longestMatch(text, start);
+
+      out.append(text.substr(copied, start - copied));
+      out.append(replacement);
+      copied = start + length;
+
+      // An empty match keeps the character after it, and the next search starts past it
+      if (length == 0) {
+        if (start == text.size()) break;
+        out.push_back(text[start]);
+        copied = start + 1;
+      }
+
+      from = copied;
+    }
+
+    out.append(text.substr(copied));
+  });
+}
+
+Column Column::left(const Selection &indices, int cutoff) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  if (cutoff < 0){
+    cerr << "Cannot keep a negative number of characters" << endl;
+    exit(9);
+  }
+
+  return transformStrings(indices, [cutoff] (string_view text, string &out) {
+    if (cutoff > static_cast<int>(text.size())){
+      out.append(text);
+      return;
+    }
+
+    out.append(text.substr(0, cutoff));
+  });
+}
+
+Column Column::right(const Selection &indices, int start) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  if (start < 0){
+    cerr << "Cannot drop a negative number of characters" << endl;
+    exit(9);
+  }
+
+  return transformStrings(indices, [start] (string_view text, string &out) {
+    if (start > static_cast<int>(text.size())) return;
+
+    out.append(text.substr(0, text.size() - start));
+  });
+}
+
+template <typename Component>
+std::enable_if_t<is_same_v<decay_t<Component>, DateComponents> 
+              || is_same_v<decay_t<Component>, TimeComponents>
+              , Column> 
+Column::extract(const Selection &indices, const Component &mode) const {
+  if (!isDate(type)){
+    cerr << "Column is not date based" << endl;
+    exit(9);
+  }
+
+  Column converted(Datatypes::FLOAT);
+
+  // Day numbers of a run, when it is not a slice of the buffer, and their components
+  vector<int32_t> epochs;
+  vector<int32_t> extracted;
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+      using Stored = typename Buffer::value_type;
+
+      // Date components go through the calendar kernels a run at a time
+      if constexpr (is_same_v<Component, DateComponents> && is_packed_v<Buffer> &&
+                    (is_same_v<Stored, Date> || is_same_v<Stored, Datetime>)) {
+        const int32_t *days = epochs.data();
+        int count = 0;
+
+        if constexpr (is_same_v<Stored, Date> && is_index_range_v<decltype(run)>) {
+          days = buffer.raw().data() + (run.getFirst() - start);
+          count = run.size();
+        }
+        else {
+          epochs.clear();
+          for (int i : run) {
+            if constexpr (is_same_v<Stored, Date>) epochs.push_back(buffer.raw()[i - start]);
+            else epochs.push_back(microsToEpoch(buffer.raw()[i - start]));
+          }
+
+          days = epochs.data();
+          count = epochs.size();
+        }
+
+        extracted.resize(count);
+        extractEpochs(days, count, mode, extracted.data());
+
+        int position = 0;
+        for (int i : run){
+          if (segment.isNull(i - start)) converted.push(Null);
+          else converted.push(static_cast<float>(extracted[position]));
+
+          ++position;
+        }
+
+        return;
+      }
+
+      for (int i : run){
+        int local = i - start;
+
+        if (segment.isNull(local)){
+          converted.push(Null);
+        }
+        // Time components are integer arithmetic on the packed microseconds
+        else if constexpr (is_same_v<Component, TimeComponents> && is_same_v<Stored, Time>){
+          converted.push(static_cast<float>(extractMicros(buffer.raw()[local], mode)));
+        }
+        else if constexpr (is_same_v<Component, TimeComponents> && is_same_v<Stored, Datetime>){
+          converted.push(static_cast<float>(extractMicros(microsOfDay(buffer.raw()[local]), mode)));
+        }
+        else if constexpr (is_same_v<Component, DateComponents> && 
+                           (is_same_v<Stored, Date> || is_same_v<Stored, Datetime>)){
+          converted.push(static_cast<float>(buffer[local].extract(mode)));
+        }
+        else {
+          cerr << "Component cannot be extracted from this column" << endl;
+          exit(9);
+        }
+      }
+    });
+  });
+
+  return converted;
+}
+
+template Column Column::extract<DateComponents>(const Selection &, const DateComponents &) const;
+template Column Column::extract<TimeComponents>(const Selection &, const TimeComponents &) const;
+
+// Applies kernel(type_identity<Stored>(), value) to the packed value (see Packing) of
+// every non null cell in indices, into a column of the same type. Results are pushed
+// already packed, so no Date, Time or Datetime is built per row
+template <typename Kernel>
+Column Column::mapPacked(const Selection &indices, Kernel kernel) const {
+  ColumnConstraints constraints;
+  constraints.TimePrecision = timePrecision;
+
+  Column converted(type, constraints);
+  converted.storage.reserve(indices.size());
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+
+      if constexpr (is_packed_v<Buffer>) {
+        const auto &values = buffer.raw();
+
+        for (int i : run){
+          if (segment.isNull(i - start)) converted.storage.push(Null);
+          else converted.storage.pushPacked(kernel(type_identity<typename Buffer::value_type>(), values[i - start]));
+        }
+      }
+    });
+  });
+
+  return converted;
+}
+
+// Works strictly on string types
+Column Column::parseTemporal(const Selection &indices, const Datatypes target, const int precision) const {
+  if (!isString(type)){
+    cerr << "Column is not string based" << endl;
+    exit(9);    
+  }
+
+  if (!isDate(target)){
+    cerr << "Strings can only be parsed into DATE, TIME or DATETIME" << endl;
+    exit(9);
+  }
+
+  ColumnConstraints constraints;
+  constraints.TimePrecision = target == Datatypes::DATE ? -1 : precision;
+
+  Column converted(target, constraints);
+  converted.storage.reserve(indices.size());
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    for (int i : run){
+      if (segment.isNull(i - start)) {
+        converted.storage.push(Null);
+        continue;
+      }
+
+      string_view text = segment.getStringView(i - start);
+
+      bool parsed = false;
+      int32_t epoch;
+      int64_t micros;
+
+      switch (target) {
+        case Datatypes::DATE:
+          parsed = parseIsoDate(text, epoch);
+          micros = epoch;
+          break;
+        case Datatypes::TIME:
+          parsed = parseIsoTime(text, micros, precision);
+          break;
+        default:
+          parsed = parseIsoDatetime(text, micros, precision);
+          break;
+      }
+
+      if (!parsed){
+        cerr << "Row " << i << " does not hold a valid date or time: " << text << endl;
+        exit(3);
+      }
+
+      converted.storage.pushPacked(micros);
+    }
+  });
+
+  return converted;
+}
+
+// Works on DATE and DATETIME columns
+Column Column::dateAdd(const Selection &indices, const int difference, const DateComponents mode) const {
+  if (type != Datatypes::DATE && type != Datatypes::DATETIME){
+    cerr << "Column is not date based" << endl;
+    exit(9);
+  }
+
+  return mapPacked(indices, [difference, mode] (auto stored, const int64_t value) -> int64_t {
+    if constexpr (is_same_v<typename decltype(stored)::type, Date>) {
+      return addToEpoch(value, difference, mode);
+    }
+
+    // The time of day rides along unchanged
+    int epoch = microsToEpoch(value);
+    return value + (addToEpoch(epoch, difference, mode) - (int64_t)epoch) * MICROS_PER_DAY;
+  });
+}
+
+// Works on DATETIME columns, on the fixed point representation
+Column Column::datetimeAdd(const Selection &indices, const double difference, const TimeComponents mode) const {
+  if (type != Datatypes::DATETIME){
+    cerr << "Column is not datetime based" << endl;
+    exit(9);
+  }
+
+  const int64_t shift = static_cast<int64_t>(difference) * microsPerComponent(mode);
+
+  return mapPacked(indices, [shift] (auto, const int64_t value) -> int64_t {
+    return value + shift;
+  });
+}
+
+// Works on DATE and DATETIME columns
+Column Column::timeBucket(const Selection &indices, const int width, const DateComponents unit) const {
+  if (type != Datatypes::DATE && type != Datatypes::DATETIME){
+    cerr << "Column is not date based" << endl;
+    exit(9);
+  }
+
+  if (width <= 0){
+    cerr << "Bucket width must be positive" << endl;
+    exit(3);
+  }
+
+  return mapPacked(indices, [width, unit] (auto stored, const int64_t value) -> int64_t {
+    if constexpr (is_same_v<typename decltype(stored)::type, Date>) {
+      return bucketEpoch(value, width, unit);
+    }
+
+    return (bucketEpoch(microsToEpoch(value), width, unit) - (int64_t)1) * MICROS_PER_DAY;
+  });
+}
+
+// Works on TIME and DATETIME columns
+Column Column::timeBucket(const Selection &indices, const int width, const TimeComponents unit) const {
+  if (type != Datatypes::TIME && type != Datatypes::DATETIME){
+    cerr << "Column is not time based" << endl;
+    exit(9);
+  }
+
+  if (width <= 0){
+    cerr << "Bucket width must be positive" << endl;
+    exit(3);
+  }
+
+  const int64_t micros = width * microsPerComponent(unit);
+
+  return mapPacked(indices, [micros] (auto, const int64_t value) -> int64_t {
+    return roundDown(value, micros);
+  });
+}
+
+Column Column::dateTrunc(const Selection &indices, const DateComponents mode) const {
+  return timeBucket(indices, 1, mode);
+}
+
+Column Column::dateTrunc(const Selection &indices, const TimeComponents mode) const {
+  return timeBucket(indices, 1, mode);
+}
+
+// Selected cells of a DATE or DATETIME column as microseconds since 0001-01-01, in
+// the order of indices. nulls flags the NULL cells
+void Column::gatherMicros(const Selection &indices, vector<int64_t> &micros, vector<uint8_t> &nulls) const {
+  if (type != Datatypes::DATE && type != Datatypes::DATETIME){
+    cerr << "Column is not date based" << endl;
+    exit(9);
+  }
+
+  micros.reserve(indices.size());
+  nulls.reserve(indices.size());
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+
+      if constexpr (is_packed_v<Buffer>) {
+        using Stored = typename Buffer::value_type;
+        const auto &values = buffer.raw();
+
+        for (int i : run){
+          if constexpr (is_same_v<Stored, Date>) micros.push_back((values[i - start] - (int64_t)1) * MICROS_PER_DAY);
+          else micros.push_back(values[i - start]);
+
+          nulls.push_back(segment.isNull(i - start));
+        }
+      }
+    });
+  });
+}
+
+Column Column::dateDiff(const Selection &indices, const Column &other, const DateComponents mode) const {
+  if (other.size() != size()){
+    cerr << "Columns are not the same size" << endl;
+    exit(10);
+  }
+
+  vector<int64_t> from, to;
+  vector<uint8_t> fromNulls, toNulls;
+  gatherMicros(indices, from, fromNulls);
+  other.gatherMicros(indices, to, toNulls);
+
+  Column converted(Datatypes::INT);
+  converted.storage.reserve(from.size());
+
+  for (size_t i = 0; i < from.size(); ++i) {
+    if (fromNulls[i] || toNulls[i]) converted.storage.push(Null);
+    else converted.storage.push(epochDiff(microsToEpoch(from[i]), microsToEpoch(to[i]), mode));
+  }
+
+  return converted;
+}
+
+// Counts unit boundaries crossed, same as the scalar dateDiff
+Column Column::dateDiff(const Selection &indices, const Column &other, const TimeComponents mode) const {
+  if (other.size() != size()){
+    cerr << "Columns are not the same size" << endl;
+    exit(10);
+  }
+
+  vector<int64_t> from, to;
+  vector<uint8_t> fromNulls, toNulls;
+  gatherMicros(indices, from, fromNulls);
+  other.gatherMicros(indices, to, toNulls);
+
+  const int64_t unit = microsPerComponent(mode);
+
+  Column converted(Datatypes::INT);
+  converted.storage.reserve(from.size());
+
+  for (size_t i = 0; i < from.size(); ++i) {
+    if (fromNulls[i] || toNulls[i]) converted.storage.push(Null);
+    else converted.storage.push(static_cast<int>(to[i] / unit - from[i] / unit));
+  }
+
+  return converted;
+}
+
+Column Column::nullIf(const Selection &indices, const Types &rhs) const {
+  Column converted(type, {unique, true, isPrimaryKey, isForeignKey, 
+                          defaultValue, timePrecision, charLength, dictionaryEncoded});
+
+  indices.forEach([&] (int i) {
+    bool areEqual = std::visit([] (const auto &lhs, const auto &rhs) -> bool {
+      using lhsT = decay_t<decltype(lhs)>;
+      using rhsT = decay_t<decltype(rhs)>;
+
+      if constexpr (is_same_v<lhsT, rhsT> || (is_arithmetic_v<lhsT> && is_arithmetic_v<rhsT>) ||
+                    (is_string_v<lhsT> && is_string_v<rhsT>)){
+        return lhs == rhs;
+      }
+      
+      return false;
+    }, storage.get(i), rhs);
+
+    if (areEqual) converted.push(Null);
+    else converted.push(storage.get(i));
+  });
+
+  return converted;
+}
+
+Column Column::coalesce(const Selection &indices, const Types &rhs) const {
+  Column converted(type, {unique, false, isPrimaryKey, isForeignKey, 
+                          validNonNullDefaultValue(type), timePrecision, charLength, dictionaryEncoded});  
+
+  indices.forEach([&] (int i) {
+    if (storage.isNull(i)){
+      converted.push(rhs);
+    }
+    else{
+      converted.push(storage.get(i));
+    }
+  });
+
+  return converted;
+}
+
+double Column::sum(const Selection &indices) const {
+  double total = 0;
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+      if constexpr (is_numeric_storage_v<Stored> && is_index_range_v<decltype(run)>) {
+        total += sumValues(buffer.data(), run.getFirst() - start, run.getLast() - start, segment.validityWords());
+      }
+      else {
+        segment.forEachValid(run, start, [&] (int i) {
+          if constexpr (is_numeric_storage_v<Stored>) total += buffer[i];
+          else total += segment.getNumeric<double>(i);
+        });
+      }
+    });
+  });
+
+  return total;
+}
+
+// What a stored cell is keyed by when looking for distinct values. Equal keys are
+// equal cells: CHAR is stored unpadded, and dictionary entries are never duplicated
+template <typename Buffer>
+auto distinctKey(const Buffer &buffer, const int index) {
+  if constexpr (is_packed_v<Buffer>) return buffer.raw()[index];
+  else if constexpr (is_dictionary_v<Buffer>) {
+    if constexpr (is_same_v<typename Buffer::value_type, string>) return string_view(buffer[index]);
+    else return string_view(buffer[index].value);
+  }
+  else if constexpr (requires {buffer.view(index);}) return buffer.view(index);
+  else return buffer[index];
+}
+
+// Calls func(segment, local) on the first cell of every distinct non null value in
+// indices. Cells go into a HashSet keyed by what their buffer stores, so no Types is
+// built per cell. Dictionary codes are only looked up in the set the first time they
+// show up in a segment
+void Column::forEachDistinct(const Selection &indices, const function<void(const ColumnSegment&, int)> &func) const {
+  const vector<ColumnSegment> &segments = storage.getSegments();
+  if (segments.empty()) return;
+
+  // All segments of a column have the same buffer type, the first one picks the key
+  segments.front().visit([&] (const auto &first) {
+    using Buffer = decay_t<decltype(first)>;
+
+    HashSet<decltype(distinctKey(first, 0))> seen;
+    const ColumnSegment *seenSegment = nullptr;
+    vector<uint8_t> seenCodes;
+
+    storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+      segment.visit([&] (const auto &buffer) {
+        if constexpr (is_same_v<decay_t<decltype(buffer)>, Buffer>) {
+          if constexpr (is_dictionary_v<Buffer>) {
+            if (seenSegment != &segment) {
+              seenSegment = &segment;
+              seenCodes.assign(buffer.getEntries().size(), false);
+            }
+          }
+
+          segment.forEachValid(run, start, [&] (int i) {
+            if constexpr (is_dictionary_v<Buffer>) {
+              int code = buffer.getCodes()[i];
+              if (seenCodes[code]) return;
+
+              seenCodes[code] = true;
+            }
+
+            if (seen.insert(distinctKey(buffer, i))) func(segment, i);
+          });
+        }
+      });
+    });
+  });
+}
+
+// Does not do type checking. will attempt to convert strings to numbers
+double Column::sumDistinct(const Selection &indices) const { 
+  double total = 0;
+
+  forEachDistinct(indices, [&total] (const ColumnSegment &segment, int i) {
+    total += segment.getNumeric<double>(i);
+  });
+
+  return total;
+}
+
+// Columns without nulls never have to look at the cells
+int Column::count(const Selection &indices) const {
+  if (!storage.hasNulls()) return indices.size();
+
+  int total = 0;
+  indices.forEach([&] (int i) {
+    total += !storage.isNull(i);
+  });
+
+  return total;
+}
+
+int Column::countDistinct(const Selection &indices) const {
+  int total = 0;
+  forEachDistinct(indices, [&total] (const ColumnSegment &, int) {++total;});
+
+  return total;
+}
+
+int Column::approxCountDistinct(const Selection &indices, int precision) const {
+  return std::llround(distinctSketch(indices, precision).estimate());
+}
+
+// Cells are hashed by the same keys forEachDistinct uses. Dictionary entries are
+// hashed once per segment, and rows just pick up the hash of their code
+HyperLogLog Column::distinctSketch(const Selection &indices, int precision) const {
+  HyperLogLog sketch(precision);
+
+  const ColumnSegment *hashedSegment = nullptr;
+  vector<uint64_t> entryHashes;
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Buffer = decay_t<decltype(buffer)>;
+
+      if constexpr (is_dictionary_v<Buffer>) {
+        if (hashedSegment != &segment) {
+          hashedSegment = &segment;
+          entryHashes.clear();
+
+          for (const auto &entry : buffer.getEntries()) {
+            if constexpr (is_same_v<typename Buffer::value_type, string>) entryHashes.push_back(std::hash<string_view>{}(entry));
+            else entryHashes.push_back(std::hash<string_view>{}(entry.value));
+          }
+        }
+
+        const vector<int> &codes = buffer.getCodes();
+        segment.forEachValid(run, start, [&] (int i) {sketch.add(entryHashes[codes[i]]);});
+      }
+      else {
+        using Key = decltype(distinctKey(buffer, 0));
+        segment.forEachValid(run, start, [&] (int i) {sketch.add(std::hash<Key>{}(distinctKey(buffer, i)));});
+      }
+    });
+  });
+
+  return sketch;
+}
+
+double Column::avg(const Selection &indices) const {
+  return aggregate(indices, Aggregate::AVG).avg();
+}
+
+double Column::avgDistinct(const Selection &indices) const {
+  double total = 0;
+  int distinct = 0;
+
+  forEachDistinct(indices, [&] (const ColumnSegment &segment, int i) {
+    total += segment.getNumeric<double>(i);
+    ++distinct;
+  });
+
+  return total / distinct;
+}
+
+// Dense runs over numeric buffers go through the reduction kernels, other runs are
+// scanned cell by cell, and strings still need to be parsed per cell
+double Column::max(const Selection &indices) const {
+  double max = std::numeric_limits<double>::lowest();
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+      if constexpr (is_numeric_storage_v<Stored> && is_index_range_v<decltype(run)>) {
+        Stored lowest = numeric_limits<Stored>::max();
+        Stored highest = numeric_limits<Stored>::lowest();
+
+        if (minMaxValues(buffer.data(), run.getFirst() - start, run.getLast() - start, segment.validityWords(), lowest, highest)) {
+          max = std::max(max, static_cast<double>(highest));
+        }
+      }
+      else {
+        segment.forEachValid(run, start, [&] (int i) {
+          if constexpr (is_numeric_storage_v<Stored>) max = std::max(max, static_cast<double>(buffer[i]));
+          else max = std::max(max, segment.getNumeric<double>(i));
+        });
+      }
+    });
+  });
+
+  return max;
+}
+
+double Column::min(const Selection &indices) const {
+  double min = std::numeric_limits<double>::max();
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+      if constexpr (is_numeric_storage_v<Stored> && is_index_range_v<decltype(run)>) {
+        Stored lowest = numeric_limits<Stored>::max();
+        Stored highest = numeric_limits<Stored>::lowest();
+
+        if (minMaxValues(buffer.data(), run.getFirst() - start, run.getLast() - start, segment.validityWords(), lowest, highest)) {
+          min = std::min(min, static_cast<double>(lowest));
+        }
+      }
+      else {
+        segment.forEachValid(run, start, [&] (int i) {
+          if constexpr (is_numeric_storage_v<Stored>) min = std::min(min, static_cast<double>(buffer[i]));
+          else min = std::min(min, segment.getNumeric<double>(i));
+        });
+      }
+    });
+  });
+
+  return min;
+}
+
+string Column::stringAggregate(const Selection &indices, string separator) const {
+  string result = "";
+
+  storage.forEachValid(indices, [&] (int i) {
+    ostringstream stringHolder;
+    stringHolder << storage.get(i);
+
+    result += stringHolder.str();
+    result += separator;
+  });
+
+  result.resize(result.size() - separator.size());
+  return result;
+}
+
+// sqrt(sigma((xi - avg)^2 / N))
+// Does not do type checking. will attempt to convert strings to numbers
+double Column::standardDeviation(const Selection &indices) const {
+  return aggregate(indices, Aggregate::STDDEV).standardDeviation();
+}
+
+// Every segment run gets its own partial state which is then merged into the total,
+// same as partial states from different threads would be. Welford's update costs a
+// division per value, so it only runs when the variance is asked for
+AggregateState Column::aggregate(const Selection &indices, const Aggregate requested) const {
+  AggregateState total;
+
+  if (!requests(requested, Aggregate::SUM | Aggregate::MIN | Aggregate::MAX | Aggregate::AVG |
+                           Aggregate::VARIANCE | Aggregate::STDDEV)) {
+    total.count = count(indices);
+    return total;
+  }
+
+  const bool trackVariance = requests(requested, Aggregate::VARIANCE | Aggregate::STDDEV);
+
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    AggregateState partial;
+
+    segment.visit([&] (const auto &buffer) {
+      using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+      // Without the variance, dense numeric runs reduce to the kernels
+      if constexpr (is_numeric_storage_v<Stored> && is_index_range_v<decltype(run)>) {
+        if (!trackVariance) {
+          int first = run.getFirst() - start;
+          int last = run.getLast() - start;
+          const uint64_t *validity = segment.validityWords();
+
+          if (requests(requested, Aggregate::MIN | Aggregate::MAX)) {
+            Stored lowest = numeric_limits<Stored>::max();
+            Stored highest = numeric_limits<Stored>::lowest();
+
+            int folded = minMaxValues(buffer.data(), first, last, validity, lowest, highest);
+            if (folded) {
+              partial.min = lowest;
+              partial.max = highest;
+            }
+
+            // NaN cells still count as rows
+            if constexpr (is_floating_point_v<Stored>) partial.count = countValid(first, last, validity);
+            else partial.count = folded;
+          }
+          else {
+            partial.count = countValid(first, last, validity);
+          }
+
+          if (requests(requested, Aggregate::SUM | Aggregate::AVG)) {
+            partial.sum = sumValues(buffer.data(), first, last, validity);
+          }
+
+          return;
+        }
+      }
+
+      segment.forEachValid(run, start, [&] (int i) {
+        if constexpr (is_numeric_storage_v<Stored>) partial.add(static_cast<double>(buffer[i]), trackVariance);
+        else partial.add(segment.getNumeric<double>(i), trackVariance);
+      });
+    });
+
+    total.merge(partial);
+  });
+
+  return total;
+}
+
+// Calls func(value) with every non null, non NaN cell of indices as a double
+template <typename Func>
+void Column::forEachNumber(const Selection &indices, Func func) const {
+  storage.forEachRun(indices, [&] (const ColumnSegment &segment, const auto &run, const int start) {
+    segment.visit([&] (const auto &buffer) {
+      using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+      segment.forEachValid(run, start, [&] (int i) {
+        double value;
+        if constexpr (is_numeric_storage_v<Stored>) value = buffer[i];
+        else value = segment.getNumeric<double>(i);
+
+        if (!std::isnan(value)) func(value);
+      });
+    });
+  });
+}
+
+// Does not do type checking. will attempt to convert strings to numbers
+double Column::percentile(const Selection &indices, const double q) const {
+  if (q < 0 || q > 1) {
+    cerr << "Percentile must be between 0 and 1" << endl;
+    exit(3);
+  }
+
+  vector<double> values;
+  values.reserve(indices.size());
+  forEachNumber(indices, [&values] (double value) {values.push_back(value);});
+
+  if (values.empty()) return std::numeric_limits<double>::quiet_NaN();
+
+  double rank = q * (values.size() - 1);
+  auto lower = values.begin() + static_cast<size_t>(rank);
+  std::nth_element(values.begin(), lower, values.end());
+
+  double fraction = rank - std::floor(rank);
+  if (fraction == 0) return *lower;
+
+  // Everything after lower is at least as big, so the next rank is their minimum
+  double upper = *std::min_element(lower + 1, values.end());
+  return *lower + (upper - *lower) * fraction;
+}
+
+double Column::median(const Selection &indices) const {
+  return percentile(indices, 0.5);
+}
+
+double Column::approxPercentile(const Selection &indices, const double q, const double compression) const {
+  return percentileSketch(indices, compression).quantile(q);
+}
+
+TDigest Column::percentileSketch(const Selection &indices, const double compression) const {
+  TDigest digest(compression);
+  forEachNumber(indices, [&digest] (double value) {digest.add(value);});
+
+  return digest;
+}
+
+////// Private methods
+void Column::enforceCellContraint(const Types &cell, const bool comesFromBulk) const {
+  // Data type check
+  if (getType(cell) != type && getType(cell) != Datatypes::NULLVALUE){
+    cerr << "Datatype does not match the type of column" << endl;
+    exit(5);
+  }
+  
+  // Uniqueness (when coming in after the column has been created)
+  if (unique && !comesFromBulk && cell != Null && contains(cell)){
+    cerr << "Uniqueness constraint not met" << endl;
+    exit(5);
+  }
+
+  // Takes nulls 
+  if (isNull(cell) && !takesNulls){
+    cerr << "(Does not take) Nulls constraint not met" << endl;
+    exit(5);
+  }
+
+  // Time Precision
+  if (holds_alternative<Time>(cell) && timePrecision != -1 && get<Time>(cell).precision != timePrecision) {
+    cerr << "Time precision constraint not met" << endl;
+    exit(5);
+  }
+
+  if (holds_alternative<Datetime>(cell) && timePrecision != -1 && get<Datetime>(cell).time.precision != timePrecision) {
+    cerr << "Time precision constraint not met" << endl;
+    exit(5);
+  }
+
+  // CharLength Precision. Cells only keep their characters, so what has to fit is
+  // the value itself. Bulk inserts are checked all at once in enforceWholeColumnConstraints
+  const Varchar *chars = holds_alternative<Varchar>(cell) ? &get<Varchar>(cell) :
+                         holds_alternative<SQLChar>(cell) ? &get<SQLChar>(cell) : nullptr;
+
+  if (chars && charLength != -1 && !comesFromBulk && static_cast<int>(chars->value.size()) > charLength) {
+    cerr << "Char length constraint not met" << endl;
+    exit(5);
+  }
+}
+
+bool Column::contains(const Types &cell) const {
+  for (int i = 0; i < size(); ++i){
+    if (storage.get(i) == cell) return true;
+  }
+
+  return false;
+}
+
+void Column::enforceWholeColumnConstraints() const {
+  vector<Types> cells = static_cast<vector<Types>>(*this);
+
+  for (const Types &cell : cells){
+    enforceCellContraint(cell, true);
+  }
+
+  if (charLength != -1 && storage.longestString() > charLength) {
+    cerr << "Char length constraint not met" << endl;
+    exit(5);
+  }
+
+  // Uniqueness must be enforced here. Since we supoprt instantiating this object
+  // with a vector, we must check this independently
+  if (!unique) return;
+
+  int distinct = 0;
+  forEachDistinct(Selection::all(size()), [&distinct] (const ColumnSegment &, int) {++distinct;});
+
+  // All NULLs together count as one value
+  if (distinct + storage.hasNulls() != size()) {
+    cerr << "Uniqueness constraint not met" << endl;
+    exit(5);
+  }
+}
+
+Types validNonNullDefaultValue(Datatypes type) {
+  switch (type) {
+    case (Datatypes::BIGINT): {
+      return static_cast<int64_t>(0);
+    } 
+    case (Datatypes::BOOL): {
+      return false;
+    }
+    case (Datatypes::CHAR): {
+      return SQLChar();
+    }
+    case (Datatypes::DATE): {
+      return Date("2000-01-01");
+    }
+    case (Datatypes::DATETIME): {
+      return Datetime();
+    }
+    case (Datatypes::FLOAT): {
+      return static_cast<float>(0);
+    }
+    case (Datatypes::INT): {
+      return static_cast<int>(0);
+    }
+    case (Datatypes::SMALLINT): {
+      return static_cast<int16_t>(0);
+    }
+    case (Datatypes::TEXT): {
+      return "";
+    }
+    case (Datatypes::TIME): {
+      return Time();
+    }
+    case (Datatypes::VARCHAR): {
+      return Varchar();
+    }
+  }
+}
+
+///////////////////////////// Column end ////////////////////////////////
+
+
+
+
+
+
+
+
+
+
+
+
+
+////////////////////////////// Table start ///////////////////////////////
+
+// // Public
+
+// Table::Table() {}
+
+// // Add a new column to the table
+// // Ensures the datatype is supported
+// void Table::insertColumn(const string name, const string dataType){    
+//   assert(validDatatype(dataType));
+
+//   columns[name] = {};
+//   columnNames.push_back(name);
+
+//   ++numCols;
+
+//   // Populate the column with nulls for the number of rows in table
+//   for (int i = 0; i < numRows; ++i){
+//     columns[name].push_back(Null);
+//   }
+// }
+
+// // Add a new char/varchar column to the table
+// void Table::insertColumn(const string name, const string dataType, const int length){    
+//   assert(dataType == "CHAR" || dataType == "VARCHAR");
+
+//   columns[name] = {};
+//   columnNames.push_back(name);
+//   charTypeColumnLengths[name] = length;
+
+//   ++numCols;
+
+//   // Populate the column with nulls for the number of rows in table
+//   for (int i = 0; i < numRows; ++i){
+//     columns[name].push_back(Null);
+//   }
+// }
+
+// // Add a new row to the table
+// // Skips incorrectly names/non-existent columns
+// // Columns not specified get initialized as NULL
+// void Table::insertRow(Row row){
+//   for (string column : columnNames){
+//     if (row.find(column) == row.end()) row[column] = Null;
+
+//     columns[column].push_back(row[column]);
+//   }
+
+//   order.push_back(numRows);
+//   ++numRows;
+// }
+
+
+// int Table::getCharTypeLength(const string name) const {
+//   assert(columnNameExists(name));
+
+//   return charTypeColumnLengths.at(name);
+// }
+
+// // Prints out the existing SQL table
+// void Table::print() {
+//   tableValidityCheck();
+//   bool hadToCutOutValue = 0;
+//   string delimiter = " | ", numHeader = "#   ";
+
+//   // Header
+//   cout << numHeader;
+
+//   unordered_map<string, int> width;
+//   int totalSize = numHeader.size();
+//   for (string name : columnNames){
+//     width[name] = name.size();
+//     totalSize += name.size();
+//     cout << delimiter << name;
+//   }
+//   cout << "\n";
+
+//   // Separator
+//   string separator(totalSize, '='); // Why is - not monospace...
+//   cout << separator << "\n";
+
+//   // Rows, in order
+//   for (int i : order){
+//     int length = numHeader.size() - to_string(i).size();
+//     string whitespace(length, ' ');
+//     cout << i << whitespace;
+
+//     for (string name : columnNames) {
+//       Types value = columns[name][i];
+      
+
+//       // Extract the value from the cell
+//       ostringstream os;
+//       os << value;
+//       string toPrint = os.str();
+
+//       length = width[name] - toPrint.size();
+//       if (length < 0) { // Edge case where value would not fit in col
+//         toPrint.resize(width[name]); 
+//         length = 0;
+//         hadToCutOutValue = true;
+//       }
+
+//       string whitespace(length, ' ');
+//       cout << delimiter << toPrint << whitespace;
+
+//     }
+
+//     cout << "\n";
+
+//   }
+
+//   if (hadToCutOutValue){
+//     cout << "\nWARNING: Had to cut out some values since they did not fit\nConsider making your column names longer\n";
+//   }
+// }
+  
+// // Private
+
+// // General validity checks
+
+// bool Table::validDatatype(const string datatype) const {
+//   for (string valid : supportedDatatypes){
+//     if (datatype == valid) return true;
+//   }
+
+//   return false;
+// }
+
+// bool Table::columnNameExists(string const name) const {
+//   return find(columnNames.begin(), columnNames.end(), name) != columnNames.end();
+// }
+
+// // TODO: two way check: all columns in table are in columnNames,
+// // all columnNames columns exist
+// void Table::columnNameValidityCheck(){
+//   for (string name : columnNames){
+//     if (columns.find(name) == columns.end()){
+//       cerr << "Column " << name << " found in columnNames but not in columns" << endl;
+//       exit(1);
+//     }
+//   }
+
+//   if (columnNames.size() != columns.size()){
+//     cerr << "mismatch between the number of elements in columns and columnNames" << endl;
+//     exit(1);
+//   }
+// }
+    
+// void Table::tableValidityCheck() {
+//   if (numCols != columns.size()) {
+//     cerr << "numCols and actual number of columns missaligned" << endl;
+//     exit(1);
+//   }
+
+//   for (string name : columnNames) {
+//     if (numRows != columns[name].size()) {
+//       cerr << "numRows and actual number of entries missaligned in " << name << endl;
+//       exit(1);
+//     }
+//   }
+
+// }
+
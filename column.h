@@ -3,10 +3,25 @@
 #include <iostream>
 #include <sstream>
 #include <set>
+#include <unordered_set>
 #include <cmath>
 #include <limits>
 #include <cctype>
+#include <functional>
 #include "datatypes.h"
+#include "storage.h"
+#include "filter.h"
+#include "aggregate.h"
+#include "reduce.h"
+#include "hashset.h"
+#include "hyperloglog.h"
+#include "tdigest.h"
+#include "textcase.h"
+#include "ahocorasick.h"
+#include "like.h"
+#include "regexp.h"
+#include "isoparse.h"
+#include "csvparse.h"
 
 enum class TrimModes {
   LEADING,
@@ -24,8 +39,94 @@ struct ColumnConstraints {
 
   int TimePrecision = -1; // Indicates it can be anything
   int CharLength = -1; // Indicates it can be anything
+
+  // Only valid on string columns. Stores each distinct value once, cells become codes
+  bool DictionaryEncoded = false;
+
+  // Rows per segment (row group) of the storage
+  int SegmentRows = ColumnStorage::DEFAULT_SEGMENT_ROWS;
+};
+
+// Maps the std comparison functors onto their transparent versions, so typed
+// kernels can compare primitives directly instead of going through Types
+template <typename Comparator>
+struct PrimitiveComparator {
+  static constexpr bool supported = false;
+};
+
+template <typename T>
+struct PrimitiveComparator<std::equal_to<T>> {
+  static constexpr bool supported = true;
+  static constexpr CompareOp op = CompareOp::EQ;
+  using type = std::equal_to<>;
+};
+
+template <typename T>
+struct PrimitiveComparator<std::not_equal_to<T>> {
+  static constexpr bool supported = true;
+  static constexpr CompareOp op = CompareOp::NE;
+  using type = std::not_equal_to<>;
+};
+
+template <typename T>
+struct PrimitiveComparator<std::less<T>> {
+  static constexpr bool supported = true;
+  static constexpr CompareOp op = CompareOp::LT;
+  using type = std::less<>;
+};
+
+template <typename T>
+struct PrimitiveComparator<std::greater<T>> {
+  static constexpr bool supported = true;
+  static constexpr CompareOp op = CompareOp::GT;
+  using type = std::greater<>;
+};
+
+template <typename T>
+struct PrimitiveComparator<std::less_equal<T>> {
+  static constexpr bool supported = true;
+  static constexpr CompareOp op = CompareOp::LE;
+  using type = std::less_equal<>;
+};
+
+template <typename T>
+struct PrimitiveComparator<std::greater_equal<T>> {
+  static constexpr bool supported = true;
+  static constexpr CompareOp op = CompareOp::GE;
+  using type = std::greater_equal<>;
 };
 
+// Converts value to Stored when that loses nothing, so it can be compared against a
+// buffer of Stored directly and give the same result as comparing both as doubles
+template <typename Stored, typename Value>
+bool narrowExactly(const Value &value, Stored &narrowed) {
+  if constexpr (is_same_v<Stored, Value>) {
+    narrowed = value;
+    return true;
+  }
+  else if constexpr (std::numeric_limits<Stored>::digits > std::numeric_limits<double>::digits && 
+                     is_floating_point_v<Value>) {
+    // BIGINT cells past 2^53 round when made doubles, so two of them can equal the
+    // same FLOAT value. Only comparing as doubles keeps that
+    return false;
+  }
+  else {
+    double wide = static_cast<double>(value);
+
+    if constexpr (is_integral_v<Stored>) {
+      // Written so NaN fails too. -min is a power of 2, so it converts exactly
+      constexpr double lowest = static_cast<double>(std::numeric_limits<Stored>::min());
+      if (!(wide >= lowest && wide < -lowest)) return false;
+    }
+    else {
+      if (!(std::abs(wide) <= std::numeric_limits<Stored>::max())) return false;
+    }
+
+    narrowed = static_cast<Stored>(wide);
+    return static_cast<double>(narrowed) == wide;
+  }
+}
+
 // Will need to create metaprogram type traits or just regular functions to
 // Check if a cast is possible. Or just let it crash normally lol
 
@@ -41,6 +142,12 @@ class Column {
 
     void push();
     void push(const Types value);
+
+    // Appends field, the text of a .csv cell, parsed straight into storage (see
+    // csvparse.h and isoparse.h). An empty field or NULL is a NULL cell. Returns false,
+    // appending nothing, if field isn't a value of the column's type. Constraints are
+    // checked as in push, all but uniqueness
+    bool pushField(string_view field);
     void update(int index, const Types newValue);
 
     void pop();   
@@ -51,79 +158,240 @@ class Column {
 
     template <typename Comparator>
     bool meetsCondition(const int index, const Types &rhs, const Comparator &comp) const {
-      return comp(col[index], rhs);
+      return comp(storage.get(index), rhs);
     }
 
-    // Needs to be here to avert linker errors
+    // Needs to be here to avert linker errors. Matches are collected as a bitmap over
+    // the rows, and handed back in whatever form suits how many there are
     template <typename Comparator>
-    vector<int> indicesMeetingCondition(const Types &rhs, const Comparator &comp) const {
-      vector<int> goodIndices;
-      for (int i = 0; i < col.size(); ++i) {
-        if (meetsCondition(i, rhs, comp)) goodIndices.push_back(i);
+    Selection indicesMeetingCondition(const Types &rhs, const Comparator &comp) const {
+      Bitmap goodIndices;
+      goodIndices.reserve(size());
+
+      if constexpr (PrimitiveComparator<Comparator>::supported) {
+        const bool nullsMeet = comp(Types(Null), rhs);
+
+        // Numeric column against a numeric value: the typed buffers go through the kernels
+        if (isNumeric(type) && isNumeric(getType(rhs))) {
+          storage.forEachSegment([&] (const ColumnSegment &segment, int) {
+            segment.visit([&] (const auto &buffer) {
+              using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+              std::visit([&] (const auto &value) {
+                if constexpr (is_numeric_storage_v<Stored> && is_arithmetic_v<decay_t<decltype(value)>>) {
+                  filterPrimitives<Comparator>(segment, buffer, value, nullsMeet, goodIndices);
+                }
+              }, rhs);
+            });
+          });
+
+          return Selection::adaptive(std::move(goodIndices));
+        }
+
+        // BOOL against a bool: cells are bytes holding 0 or 1
+        if (type == Datatypes::BOOL && getType(rhs) == Datatypes::BOOL) {
+          const uint8_t value = get<bool>(rhs);
+
+          storage.forEachSegment([&] (const ColumnSegment &segment, int) {
+            segment.visit([&] (const auto &buffer) {
+              if constexpr (is_same_v<decay_t<decltype(buffer)>, vector<uint8_t>>) {
+                filterPrimitives<Comparator>(segment, buffer, value, nullsMeet, goodIndices);
+              }
+            });
+          });
+
+          return Selection::adaptive(std::move(goodIndices));
+        }
+
+        // DATE/TIME/DATETIME against a value of the same type: packing preserves
+        // ordering, so compare the day numbers/microseconds straight from the buffers
+        if (isDate(type) && getType(rhs) == type) {
+          storage.forEachSegment([&] (const ColumnSegment &segment, int) {
+            segment.visit([&] (const auto &buffer) {
+              using Buffer = decay_t<decltype(buffer)>;
+
+              if constexpr (is_packed_v<Buffer>) {
+                const auto &value = get<typename Buffer::value_type>(rhs);
+                filterPrimitives<Comparator>(segment, buffer.raw(), buffer.pack(value), nullsMeet, goodIndices);
+              }
+            });
+          });
+
+          return Selection::adaptive(std::move(goodIndices));
+        }
+      }
+
+      // Dictionary encoded strings: evaluate the condition once per distinct value
+      // of each segment, every cell is then just a lookup on its code
+      if (dictionaryEncoded) {
+        const bool nullsMeet = comp(Types(Null), rhs);
+
+        storage.forEachSegment([&] (const ColumnSegment &segment, int) {
+          segment.visit([&] (const auto &buffer) {
+            if constexpr (is_dictionary_v<decay_t<decltype(buffer)>>) {
+              vector<uint8_t> entryMeets;
+              for (const auto &entry : buffer.getEntries()) {
+                entryMeets.push_back(comp(fromStorage(entry), rhs));
+              }
+
+              const vector<int> &codes = buffer.getCodes();
+              for (int i = 0; i < buffer.size(); ++i) {
+                goodIndices.push(segment.isNull(i) ? nullsMeet : entryMeets[codes[i]]);
+              }
+            }
+          });
+        });
+
+        return Selection::adaptive(std::move(goodIndices));
       }
 
-      return goodIndices;
+      for (int i = 0; i < size(); ++i) {
+        goodIndices.push(meetsCondition(i, rhs, comp));
+      }
+
+      return Selection::adaptive(std::move(goodIndices));
     }
 
+    // Rows matching a SQL LIKE pattern, see LikePattern. The pattern is compiled once,
+    // and dictionary encoded columns only match each distinct value once per segment.
+    // NULL rows are in neither like nor notLike. ilike folds ASCII case
+    Selection like(const string &pattern, const char escape='\\') const;
+    Selection ilike(const string &pattern, const char escape='\\') const;
+    Selection notLike(const string &pattern, const char escape='\\') const;
+    Selection notIlike(const string &pattern, const char escape='\\') const;
+
+    // Rows where the regular expression matches somewhere (REGEXP_LIKE), see Regex.
+    // Patterns are compiled once and cached across calls. NULL rows never match
+    Selection regexpLike(const string &pattern, const bool caseInsensitive=false) const;
+
     ////// Temporary column creation functions
-    Column round(const vector<int> &indices, int decimals) const;
-    Column ceiling(const vector<int> &indices) const;
-    Column floor(const vector<int> &indices) const;
-    Column absolute(const vector<int> &indices) const;
-
-    Column length(const vector<int> &indices) const;
-    Column concat(const vector<int> &indices, string toConcatenate) const;
-    Column upper(const vector<int> &indices) const;
-    Column lower(const vector<int> &indices) const;
-    Column initCap(const vector<int> &indices) const;
-    Column substring(const vector<int> &indices, int startPos, int length) const;
-    Column trim(const vector<int> &indices, const TrimModes mode, char toRemove=' ') const;
-    Column replace(const vector<int> &indices, 
+    Column round(const Selection &indices, int decimals) const;
+    Column ceiling(const Selection &indices) const;
+    Column floor(const Selection &indices) const;
+    Column absolute(const Selection &indices) const;
+
+    Column length(const Selection &indices) const;
+    Column concat(const Selection &indices, string toConcatenate) const;
+    Column upper(const Selection &indices) const;
+    Column lower(const Selection &indices) const;
+    Column initCap(const Selection &indices) const;
+    Column substring(const Selection &indices, int startPos, int length) const;
+    Column trim(const Selection &indices, const TrimModes mode, char toRemove=' ') const;
+    // Replaces every occurrence of substr, left to right and without overlaps
+    Column replace(const Selection &indices, 
                    const string &substr, const string &newVal) const;
-    Column left(const vector<int> &indices, int cutoff) const;
-    Column right(const vector<int> &indices, int start) const;
+
+    // Several (pattern, replacement) pairs in a single pass over each row. Where
+    // patterns overlap the leftmost match wins, then the longest one starting there
+    Column replace(const Selection &indices, const vector<pair<string, string>> &replacements) const;
+
+    // Every character of from becomes the one at the same place in to, or is removed
+    // if to is shorter (SQL TRANSLATE). The first occurrence in from counts
+    Column translate(const Selection &indices, const string &from, const string &to) const;
+
+    // First (leftmost, then longest) match of the regular expression, an empty string
+    // where there is none
+    Column regexpExtract(const Selection &indices, const string &pattern, const bool caseInsensitive=false) const;
+
+    // Every non overlapping match of the regular expression becomes replacement,
+    // taken literally. Empty matches insert it between characters
+    Column regexpReplace(const Selection &indices, const string &pattern, 
+                         const string &replacement, const bool caseInsensitive=false) const;
+    Column left(const Selection &indices, int cutoff) const;
+    Column right(const Selection &indices, int start) const;
 
     template <typename Component>
     std::enable_if_t<is_same_v<decay_t<Component>, DateComponents> 
                   || is_same_v<decay_t<Component>, TimeComponents>
                   , Column> 
-           extract(const vector<int> &indices, const Component &mode) const;
+           extract(const Selection &indices, const Component &mode) const;
+
+    // Parses a string column into a DATE, TIME or DATETIME column (see isoparse.h),
+    // straight into the packed cells. Strings that don't parse exit with code 3
+    Column parseTemporal(const Selection &indices, const Datatypes target, const int precision=6) const;
+
+    // DATEADD over DATE and DATETIME columns, worked out on the stored day numbers and
+    // microseconds. Month based units clamp the day to the month landed on, see addToEpoch
+    Column dateAdd(const Selection &indices, const int difference, const DateComponents mode) const;
+
+    // DATETIME columns only, any amount and sign (truncated to whole units)
+    Column datetimeAdd(const Selection &indices, const double difference, const TimeComponents mode) const;
+
+    // DATEDIFF from each row of this column to the same row of other, as an INT column,
+    // NULL where either is. Both must be DATE or DATETIME, in any combination
+    Column dateDiff(const Selection &indices, const Column &other, const DateComponents mode) const;
+    Column dateDiff(const Selection &indices, const Column &other, const TimeComponents mode) const;
+
+    // DATE_TRUNC: start of the period of mode holding each value, weeks start on Monday.
+    // DateComponents work on DATE and DATETIME columns, TimeComponents on TIME and DATETIME
+    Column dateTrunc(const Selection &indices, const DateComponents mode) const;
+    Column dateTrunc(const Selection &indices, const TimeComponents mode) const;
+
+    // Start of the width units wide bucket holding each value. Buckets are counted from
+    // 0001-01-01 00:00:00 (midnight on TIME columns), see bucketEpoch. Both functions
+    // only round down, so a sorted column gives a sorted result
+    Column timeBucket(const Selection &indices, const int width, const DateComponents unit) const;
+    Column timeBucket(const Selection &indices, const int width, const TimeComponents unit) const;
     
     // Should this be removed and movs to a Table class? I am sure it should. keeping it here for now just in case
     // template <typename Comparison>
-    // Column caseWhen(const vector<int> &indices, const Comparison &comp, 
+    // Column caseWhen(const Selection &indices, const Comparison &comp, 
     //                 const Types &whenTrue, const Types &whenFalse) const;
-    Column nullIf(const vector<int> &indices, const Types &rhs) const;
-    Column coalesce(const vector<int> &indices, const Types &rhs) const;
+    Column nullIf(const Selection &indices, const Types &rhs) const;
+    Column coalesce(const Selection &indices, const Types &rhs) const;
     
 
     // Don't wanna deal with this one now, it will involve writing a lot of boilerplate for explicit casts
-    Column cast(const vector<int> &indices, const Datatypes &type);
+    Column cast(const Selection &indices, const Datatypes &type);
                 
     ////// Aggregate functions
     // Ignore NULL
-    double sum(const vector<int> &indices) const; 
-    double sumDistinct(const vector<int> &indices) const;
+    double sum(const Selection &indices) const; 
+    double sumDistinct(const Selection &indices) const;
 
     // Ignore NULL
-    int count(const vector<int> &indices) const;
-    int countDistinct(const vector<int> &indices) const;
+    int count(const Selection &indices) const;
+    int countDistinct(const Selection &indices) const;
+
+    // Estimated with a HyperLogLog sketch in one pass and constant memory, about 1%
+    // off at the default precision. distinctSketch hands back the sketch itself, so
+    // partial results can be merged before estimating
+    int approxCountDistinct(const Selection &indices, int precision=HyperLogLog::DEFAULT_PRECISION) const;
+    HyperLogLog distinctSketch(const Selection &indices, int precision=HyperLogLog::DEFAULT_PRECISION) const;
 
     // Ignore NULL
-    double avg(const vector<int> &indices) const;
-    double avgDistinct(const vector<int> &indices) const;
+    double avg(const Selection &indices) const;
+    double avgDistinct(const Selection &indices) const;
 
     // Ignore NULL
-    double max(const vector<int> &indices) const;
-    double min(const vector<int> &indices) const;
+    double max(const Selection &indices) const;
+    double min(const Selection &indices) const;
+
+    // Population standard deviation, ignores NULL
+    double standardDeviation(const Selection &indices) const;
 
-    double standardDeviation(const vector<int> &indices) const;
+    // Ignore NULL. q goes from 0 to 1, values between two ranks are interpolated
+    // (PERCENTILE_CONT). Found by selection (nth_element), not by sorting
+    double percentile(const Selection &indices, const double q) const;
+    double median(const Selection &indices) const;
 
-    string stringAggregate(const vector<int> &indices, string separator) const;
+    // Estimated with a t-digest in one pass and bounded memory, most accurate towards
+    // the tails. percentileSketch hands back the digest, so partial results can be
+    // merged, and p50/p95/p99 can all be read from one pass
+    double approxPercentile(const Selection &indices, const double q, 
+                            const double compression=TDigest::DEFAULT_COMPRESSION) const;
+    TDigest percentileSketch(const Selection &indices, const double compression=TDigest::DEFAULT_COMPRESSION) const;
+
+    // Computes every aggregate in requested over one scan of indices, ignoring NULL.
+    // Members of the result that were not requested are left unspecified
+    AggregateState aggregate(const Selection &indices, const Aggregate requested=Aggregate::ALL) const;
+
+    string stringAggregate(const Selection &indices, string separator) const;
 
     explicit operator vector<Types> () const;
-    const Types& operator[] (int index) const;
-    Types& operator[] (int index);
+
+    // Cells are stored unboxed, so indexing hands back a materialized copy
+    Types operator[] (int index) const;
   
     Datatypes type;
 
@@ -131,6 +399,63 @@ class Column {
     int charLength = 255;
 
   private:
+    bool contains(const Types &cell) const;
+
+    // Appends whether comp(cell, value) holds for every cell of segment. When value
+    // fits the buffer's type exactly, compareValues does the work a word at a time,
+    // otherwise mixed types are compared as doubles, same as GenericTypesVisitor
+    template <typename Comparator, typename Stored, typename Value>
+    void filterPrimitives(const ColumnSegment &segment, const vector<Stored> &values, const Value &value, 
+                          const bool nullsMeet, Bitmap &goodIndices) const {
+      using Primitive = PrimitiveComparator<Comparator>;
+
+      const int count = values.size();
+      vector<uint64_t> matches((count + Bitmap::WORD_BITS - 1) / Bitmap::WORD_BITS, 0);
+
+      Stored narrowed;
+      if (narrowExactly(value, narrowed)) {
+        compareValues(values.data(), count, narrowed, Primitive::op, matches.data());
+      }
+      else {
+        typename Primitive::type comp;
+
+        for (int i = 0; i < count; ++i) {
+          bool meets = comp(static_cast<double>(values[i]), static_cast<double>(value));
+          matches[i / Bitmap::WORD_BITS] |= static_cast<uint64_t>(meets) << (i % Bitmap::WORD_BITS);
+        }
+      }
+
+      // NULL cells hold a default value, they get whatever comparing against NULL gives
+      if (segment.hasNulls()) {
+        const vector<uint64_t> &valid = segment.getValidity().data();
+
+        for (size_t w = 0; w < matches.size(); ++w) {
+          matches[w] = (matches[w] & valid[w]) | (nullsMeet ? ~valid[w] : 0);
+        }
+      }
+
+      goodIndices.append(matches.data(), count);
+    }
+
+    template <typename Transform>
+    Column transformStrings(const Selection &indices, Transform transform) const;
+
+    template <typename Kernel>
+    Column transformBytes(const Selection &indices, Kernel kernel) const;
+
+    void forEachDistinct(const Selection &indices, const function<void(const ColumnSegment&, int)> &func) const;
+
+    template <typename Func>
+    void forEachNumber(const Selection &indices, Func func) const;
+
+    template <typename Predicate>
+    Selection rowsMatching(Predicate matches) const;
+
+    void gatherMicros(const Selection &indices, vector<int64_t> &micros, vector<uint8_t> &nulls) const;
+
+    template <typename Kernel>
+    Column mapPacked(const Selection &indices, Kernel kernel) const;
+
     void enforceWholeColumnConstraints() const;
     void enforceCellContraint(const Types &cell, const bool comesFromBulk=false) const; 
 
@@ -139,7 +464,8 @@ class Column {
     bool isPrimaryKey = false;
     bool isForeignKey = false;
     Types defaultValue = Null;
-    vector<Types> col;
+    bool dictionaryEncoded = false;
+    ColumnStorage storage;
 };
 
 Types validNonNullDefaultValue(Datatypes type);
@@ -0,0 +1,66 @@
+#include "csvparse.h"
+#include <charconv>
+
+namespace {
+
+// from_chars takes no '+', and would stop at the first byte that isn't a digit
+template <typename T>
+bool parseWhole(string_view text, T &value) {
+  if (text.size() > 1 && text[0] == '+' && text[1] != '-') text.remove_prefix(1);
+
+  T parsed;
+  auto [end, error] = from_chars(text.data(), text.data() + text.size(), parsed);
+  if (error != errc() || end != text.data() + text.size()) return false;
+
+  value = parsed;
+  return true;
+}
+
+bool equalsIgnoringCase(string_view text, string_view lowercase) {
+  if (text.size() != lowercase.size()) return false;
+
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i] >= 'A' && text[i] <= 'Z' ? text[i] - 'A' + 'a' : text[i];
+    if (c != lowercase[i]) return false;
+  }
+
+  return true;
+}
+
+bool isSpace(const char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+}
+
+bool parseInteger(string_view text, int64_t &value, const int bits) {
+  int64_t parsed;
+  if (!parseWhole(text, parsed)) return false;
+
+  if (bits < 64) {
+    const int64_t limit = int64_t(1) << (bits - 1);
+    if (parsed < -limit || parsed >= limit) return false;
+  }
+
+  value = parsed;
+  return true;
+}
+
+bool parseFloat(string_view text, float &value) {
+  return parseWhole(text, value);
+}
+
+bool parseBool(string_view text, bool &value) {
+  if (text == "1" || equalsIgnoringCase(text, "true")) value = true;
+  else if (text == "0" || equalsIgnoringCase(text, "false")) value = false;
+  else return false;
+
+  return true;
+}
+
+string_view trimField(string_view text) {
+  while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+  while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+
+  return text;
+}
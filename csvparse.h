@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+using namespace std;
+
+// Parsers for the fields of a table's .csv, straight from the bytes of the line with
+// from_chars: nothing is allocated and no locale is looked at. The whole field has to
+// be the value, a leading '+' is allowed on numbers. They return false on malformed
+// or out of range input, and leave the result untouched
+
+// Integers that don't fit in bits bits are out of range (16, 32 or 64)
+bool parseInteger(string_view text, int64_t &value, const int bits=64);
+bool parseFloat(string_view text, float &value);
+
+// true or false in any case, or 1 and 0
+bool parseBool(string_view text, bool &value);
+
+// The whitespace around text dropped
+string_view trimField(string_view text);
+
+// Calls visit(field, index) on every field of line, split on commas and trimmed.
+// A ';' ending the line is dropped, an empty line is a single empty field
+template <typename Visit>
+void forEachField(string_view line, Visit visit) {
+  line = trimField(line);
+  if (!line.empty() && line.back() == ';') line.remove_suffix(1);
+
+  for (int index = 0; ; ++index) {
+    const void *comma = memchr(line.data(), ',', line.size());
+    size_t length = comma ? static_cast<const char*>(comma) - line.data() : line.size();
+
+    visit(trimField(line.substr(0, length)), index);
+
+    if (!comma) return;
+    line.remove_prefix(length + 1);
+  }
+}
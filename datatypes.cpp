@@ -1,5 +1,6 @@
 #pragma once
 #include "datatypes.h"
+#include "isoparse.h"
 #include "column.h"
 
 /////////////////////// Types helper function ////////////////////////////
@@ -39,6 +40,47 @@ Datatypes getType(const Types &value) {
 bool isNull (const Types &value){
   return std::holds_alternative<std::monostate>(value);
 }
+
+size_t hashCharacters(string_view value) {
+  size_t end = value.find_last_not_of(' ');
+  return std::hash<string_view>{}(value.substr(0, end == string_view::npos ? 0 : end + 1));
+}
+
+size_t std::hash<Varchar>::operator()(const Varchar &value) const {
+  return hashCharacters(value.value);
+}
+
+size_t std::hash<SQLChar>::operator()(const SQLChar &value) const {
+  return hashCharacters(value.value);
+}
+
+size_t std::hash<Date>::operator()(const Date &value) const {
+  return std::hash<int>{}(value.epoch);
+}
+
+size_t std::hash<Time>::operator()(const Time &value) const {
+  return std::hash<double>{}(value.duration);
+}
+
+size_t std::hash<Datetime>::operator()(const Datetime &value) const {
+  size_t seed = std::hash<Date>{}(value.date);
+  return seed ^ (std::hash<Time>{}(value.time) + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+}
+
+size_t TypesHash::operator()(const Types &value) const {
+  return std::visit([] (const auto &value) -> size_t {
+    using Type = decay_t<decltype(value)>;
+
+    if constexpr (is_arithmetic_v<Type>) return std::hash<double>{}(static_cast<double>(value));
+    else if constexpr (is_same_v<Type, string>) return hashCharacters(value);
+    else if constexpr (is_same_v<Type, monostate>) return 0;
+    else return std::hash<Type>{}(value);
+  }, value);
+}
+
+bool TypesEqual::operator()(const Types &lhs, const Types &rhs) const {
+  return (isNull(lhs) && isNull(rhs)) || lhs == rhs;
+}
 /////////////////////// Types helper functions end ////////////////////////
 
 
@@ -101,7 +143,9 @@ int Varchar::getLength() const {
 
 SQLChar::SQLChar() : Varchar() {};
 
-SQLChar::SQLChar(string Value) : Varchar(Value) {};
+SQLChar::SQLChar(string Value) : Varchar(Value) {
+  trimPadding();
+};
 
 SQLChar::SQLChar(int Length) : Varchar(Length) {
   enforceLengthInvariant();
@@ -126,21 +170,41 @@ void SQLChar::enforceLengthInvariant(){
     exit(3);
   }
 
-  if (value.size() < length){
-    int padLength = length - value.size();
-    string padding(padLength, ' ');
+  trimPadding();
+}
 
-    value += padding;
-  }
+void SQLChar::trimPadding(){
+  size_t end = value.find_last_not_of(' ');
+  value.resize(end == string::npos ? 0 : end + 1);
 }
 
-string SQLChar::getUnpaddedValue() const{
-  auto end = value.end();
-  auto begin = value.begin();
+const string& SQLChar::getUnpaddedValue() const{
+  return value;
+}
+
+string SQLChar::getValue() const {
+  return static_cast<string>(*this);
+}
+
+int SQLChar::getLength() const {
+  return std::max(length, static_cast<int>(value.size()));
+}
+
+int comparePadded(string_view lhs, string_view rhs){
+  size_t common = std::min(lhs.size(), rhs.size());
+
+  int prefix = lhs.compare(0, common, rhs, 0, common);
+  if (prefix != 0) return prefix;
 
-  while (end != begin && *(--end) == ' ');
+  // Whatever is left of the longer side is compared against the implied spaces
+  string_view rest = lhs.size() > common ? lhs.substr(common) : rhs.substr(common);
+  int sign = lhs.size() > common ? 1 : -1;
 
-  return string(begin, ++end);
+  for (char c : rest){
+    if (c != ' ') return static_cast<unsigned char>(c) < ' ' ? -sign : sign;
+  }
+
+  return 0;
 }
 
 ///////////////////////// End SQLChar //////////////////////////////////
@@ -148,7 +212,9 @@ string SQLChar::getUnpaddedValue() const{
 
 /////////////////////////// Date ///////////////////////////////////////
 
-Date::Date() : year(2000), month(1), day(1) {};
+Date::Date() : year(2000), month(1), day(1) {
+  dateToEpoch();
+};
 
 Date::Date(const int Year, const int Month, const int Day) :
           year(Year), month(Month), day(Day) {
@@ -162,96 +228,20 @@ Date::Date(const int Epoch) : epoch(Epoch) {
 
 // YYYY-MM-DD
 Date::Date(const string &YearMonthDay){
-  if (YearMonthDay.size() != 10) {
+  if (!parseIsoDate(YearMonthDay, epoch)) {
     cerr << "Incorrect format for this constructor (should be YYYY-MM-DD)" << endl;
     exit(3);
   }
 
-  year = stoi(YearMonthDay.substr(0, 4));
-  month = stoi(YearMonthDay.substr(5, 2));
-  day = stoi(YearMonthDay.substr(8, 2));
-
-  enforceDateInvariants();
-  dateToEpoch();
+  epochToDate();
 }
 
 void Date::dateToEpoch(){
-  int updatedEpoch = 0;
-
-  // Additions due to years
-  updatedEpoch += (year - 1) * 365;
-  updatedEpoch += leapDaysUpToCurrentYear();
-
-  // Additions due to months
-  if (isLeapYear() && month > 2) ++updatedEpoch;
-  int pastMonths = month;
-  while (--pastMonths > 0){
-    int daysToSubstract = daysPerMonth[pastMonths - 1];
-    updatedEpoch += daysToSubstract;
-  }
-
-  // Additions due to days
-  updatedEpoch += day;
-
-  epoch = updatedEpoch;
+  epoch = civilToEpoch(year, month, day);
 }
 
-// Fixed :)
 void Date::epochToDate(){
-  // Make a shitty loop and call it a day (for now)
-  year = 1;
-  int remainingDays = epoch;
-
-  while (remainingDays > 366){
-    remainingDays -= 365;
-    remainingDays -= isLeapYear();
-
-    ++year;
-  }
-
-  // Hardcode a solution right on the border of current year and previous
-  // in case of a leap year.
-  if (remainingDays == 366){
-    if (isLeapYear()){
-      month = 12;
-      day = 31;
-    }
-    else{
-      ++year;
-      month = 1;
-      day = 1;
-    }
-
-    return;
-  }
-
-  // Hardcode solution when the remaining days are 0, which indicates
-  // the final day of the year
-  if (remainingDays == 0){
-    --year;
-    month = 12;
-    day = 31;
-
-    return;
-  }
-
-  // Normal case, go through the months 
-  month = 0;
-  while (remainingDays > daysPerMonth[month]){
-    remainingDays -= daysPerMonth[month];
-    remainingDays -= (isLeapYear() && (month == 1)); // 1 becuase 0 indexed for now
-    ++month;
-  }
-
-  if (remainingDays == 0) { //this will only happen if we are in february on a leap year
-    day = 29;
-    month = 2;
-    return;
-  }
-
-  ++month;
-  day = remainingDays;
-
+  epochToCivil(epoch, year, month, day);
 }
 
 bool Date::isLeapYear(int const currentYear) const {
@@ -265,22 +255,6 @@ bool Date::isLeapYear() const {
   return isLeapYear(year);
 }
 
-int Date::leapDaysUpToCurrentYear(int const currentYear) const {
-  int leapYears = (currentYear - 1) / (int)4;
-
-  // Remove multiples of 100
-  leapYears -= (currentYear - 1) / (int)100;
-
-  // Add multiples of 400
-  leapYears += (currentYear - 1) / (int)400;
-
-  return leapYears; 
-}
-
-int Date::leapDaysUpToCurrentYear() const {
-  return leapDaysUpToCurrentYear(year);
-}
-
 void Date::enforceDateInvariants() const {
   bool yearCheck = (year >= 0 && year <= 9999);
   if (!yearCheck) {
@@ -308,76 +282,7 @@ void Date::enforceDateInvariants() const {
 }
 
 Date Date::dateAdd(int difference, const DateComponents mode) const {
-  Date newDate(1);
-  switch (mode) {
-    // Looking for it to fall through to days since the logic is the same
-    // But we have 7 days instead of 1
-    case DateComponents::WEEKS:
-      difference *= 7;
-
-    case DateComponents::DAYS: {
-      int newEpoch = epoch + difference;
-
-      Date newDateDays(newEpoch);
-
-      newDate = newDateDays; 
-
-      break;
-    }
-    
-    // Looking for it to fall through to months since the logic is the same
-    // but we have 3 months instead of 1
-    case DateComponents::QUARTERS:
-      difference *= 3;
-
-    case DateComponents::MONTHS: {
-      Date newDateMonths(year, month, day);
-      // Step 1: deal with years and months
-      // Deal with this tomorrow
-      int leftover = difference % 12;
-      if (leftover + month > 12){
-        ++newDateMonths.year;
-        newDateMonths.month = ((leftover + month) % 12);
-      }
-      else if (leftover + month <= 0) {
-        --newDateMonths.year;
-        newDateMonths.month = 12 + (month + leftover);
-      }
-      else {
-        newDateMonths.month += leftover;
-      }
-
-      newDateMonths.year += difference / (int)12;
-
-      // Step 2: deal with the day
-      int maxDay = daysPerMonth[newDateMonths.month - 1];
-      maxDay += ((newDateMonths.month == 2) && newDateMonths.isLeapYear());
-
-      newDateMonths.day = min(day, maxDay);
-
-      newDate = newDateMonths;
-      newDate.dateToEpoch();
-
-      break;
-    }
-    
-    case DateComponents::YEARS: {
-      Date newDateYears(year, month, day);
-
-      newDateYears.year += difference;
-
-      if ( (month == 2 && day == 29) && !newDateYears.isLeapYear() ) {
-        newDateYears.day = 28;
-      }
-      
-      newDate = newDateYears;
-      newDate.dateToEpoch();
-
-      break;
-    }
-  }  
-
-  return newDate;
+  return Date(addToEpoch(epoch, difference, mode));
 }
 
 Date Date::dateSub(const int rhs, const DateComponents mode) const {
@@ -385,42 +290,7 @@ Date Date::dateSub(const int rhs, const DateComponents mode) const {
 }
 
 int Date::extract(const DateComponents mode) const {
-  int value = 0;
-
-  switch (mode){
-    case DateComponents::DAYS: {
-      value = day;
-      break;
-    }
-
-    case DateComponents::MONTHS: {
-      value = month;
-      break;
-    }
-
-    case DateComponents::QUARTERS: {
-      value = ((month - 1) / (int)3) + 1;
-      break;
-    }
-
-    case DateComponents::YEARS: {
-      value = year;
-      break;
-    }
-
-    case DateComponents::DAYOFYEAR: {
-      for (int i = 0; i < month; ++i){
-        value += daysPerMonth[i];
-      }
-      value += ((month > 2) && isLeapYear());
-
-      value += day;
-      break;
-    }
-
-  }
-
-  return value;
+  return extractEpoch(epoch, mode);
 }
 
 //////////////////////// End Date ///////////////////////////////////////
@@ -440,21 +310,15 @@ Time::Time(double Duration, int Precision) : duration(Duration), precision(Preci
 }
 
 
-// Only guaranteed to work if string format is H[H]:M[M]:S[S][.DDDDDD]
+// H[H]:M[M]:S[S][.DDDDDD]
 Time::Time(const string &HHMMSS, int Precision) : precision(Precision) {
-  auto firstColon = find(HHMMSS.begin(), HHMMSS.end(), ':');
-  hour = stoi(string(HHMMSS.begin(), firstColon));
-
-  auto secondColon = find(firstColon+1, HHMMSS.end(), ':');
-  minute = stoi(string(firstColon+1, secondColon));
-
-  double fullSecond = stod(string(secondColon+1, HHMMSS.end()));
-  second = (int)fullSecond;
+  int64_t micros;
+  if (!parseIsoTime(HHMMSS, micros, Precision)) {
+    cerr << "Incorrect format for this constructor (should be HH:MM:SS[.DDDDDD])" << endl;
+    exit(3);
+  }
 
-  fraction = (int)((fullSecond - (double)second) * pow(10, precision)) / 1;
-    
-  timeToDuration();
-  enforceTimeInvariants();
+  *this = microsToTime(micros, Precision);
 }
 
 Time::Time(int Hour, int Minute, int Second, int Fraction, int Precision) :
@@ -580,8 +444,15 @@ Datetime::Datetime(const Date Datepart, const Time Timepart) :
 Datetime::Datetime(const string &Datepart, const string &Timepart) :
                   date(Date(Datepart)), time(Time(Timepart)) {};
 
-Datetime::Datetime(const string &full) : date(Date(string(full.begin(), full.begin() + 10))),
-                  time(Time(string(full.begin() + 11, full.end()))) {};
+Datetime::Datetime(const string &full) {
+  int64_t micros;
+  if (!parseIsoDatetime(full, micros)) {
+    cerr << "Incorrect format for this constructor (should be YYYY-MM-DDThh:mm:ss[.dddddd])" << endl;
+    exit(3);
+  }
+
+  *this = microsToDatetime(micros);
+}
 
 // Only supports values within limit (so -11 to 11 months, etc)
 Datetime Datetime::datetimeAdd(const double &difference, const DateComponents &mode) const {
@@ -591,27 +462,12 @@ Datetime Datetime::datetimeAdd(const double &difference, const DateComponents &m
   return Datetime(datePortion, timePortion);
 }
 
-// Only supports values within limit (so -23 to 23 hours, etc)
+// Done on the fixed point representation, so any amount (and sign) is supported
 Datetime Datetime::datetimeAdd(const double &difference, const TimeComponents &mode) const{
-  double endOfDay = 24*3600;
-
-  Date newDate = date;
-  
-  Time differenceAsTime(0, 0, 0);
-  differenceAsTime = differenceAsTime.timeAdd(abs(difference), mode);
-  
-  double newDuration = difference < 0 ? time.duration - differenceAsTime.duration : time.duration + differenceAsTime.duration;
-
-  if (newDuration >= endOfDay){
-    newDuration -= endOfDay;
-    newDate = newDate.dateAdd(1, DateComponents::DAYS);
-  }
-  else if (newDuration < 0){
-    newDuration += endOfDay;
-    newDate = newDate.dateSub(1, DateComponents::DAYS);
-  }
+  int64_t micros = datetimeToMicros(*this);
+  micros += static_cast<int64_t>(difference) * microsPerComponent(mode);
 
-  return Datetime(newDate, Time(newDuration, 6));
+  return microsToDatetime(micros, 6);
 } 
 
 Datetime Datetime::datetimeSub(const double &difference, const DateComponents &mode) const{
@@ -646,56 +502,266 @@ double Datetime::extract(const DatetimeComponents &mode) const {
 
 // If lhs < rhs, the value will be positive
 int dateDiff(const Datetime &lhs, const Datetime &rhs, const DateComponents &mode){
-  int jumps = 0;
+  return epochDiff(lhs.date.epoch, rhs.date.epoch, mode);
+}
 
-  switch (mode){
-    case DateComponents::YEARS: {
-      jumps = rhs.date.year - lhs.date.year;
+// If lhs < rhs, the value will be positive. Counts unit boundaries crossed,
+// so 10:59:59 -> 11:00:00 is one hour
+int dateDiff(const Datetime &lhs, const Datetime &rhs, const TimeComponents &mode) {
+  int64_t unit = microsPerComponent(mode);
+
+  return static_cast<int>(datetimeToMicros(rhs) / unit - datetimeToMicros(lhs) / unit);
+}
+
+////// Fixed point helpers
+// Size of one fraction unit, in microseconds, for each precision
+constexpr array<int64_t, 7> microsPerFraction = 
+          {1000000, 100000, 10000, 1000, 100, 10, 1};
+
+int64_t microsPerComponent(const TimeComponents mode) {
+  switch (mode) {
+    case TimeComponents::FRACTIONS: return 1;
+    case TimeComponents::SECONDS: return MICROS_PER_SECOND;
+    case TimeComponents::MINUTES: return MICROS_PER_MINUTE;
+    case TimeComponents::HOURS: return MICROS_PER_HOUR;
+  }
+
+  return 1; // Should never reach here
+}
+
+int64_t extractMicros(const int64_t micros, const TimeComponents mode) {
+  switch (mode) {
+    case TimeComponents::FRACTIONS: return micros % MICROS_PER_SECOND;
+    case TimeComponents::SECONDS: return micros / MICROS_PER_SECOND % 60;
+    case TimeComponents::MINUTES: return micros / MICROS_PER_MINUTE % 60;
+    case TimeComponents::HOURS: return micros / MICROS_PER_HOUR;
+  }
+
+  return -1; // Should never reach here
+}
+
+int64_t timeToMicros(const Time &time) {
+  int64_t micros = (time.hour * (int64_t)3600 + time.minute * 60 + time.second) * MICROS_PER_SECOND;
+  micros += time.fraction * microsPerFraction[std::min<u_int>(time.precision, 6)];
+
+  return micros;
+}
+
+Time microsToTime(int64_t micros, int precision) {
+  precision = std::clamp(precision, 0, 6);
+
+  return Time(static_cast<int>(micros / MICROS_PER_HOUR),
+              static_cast<int>(micros / MICROS_PER_MINUTE % 60),
+              static_cast<int>(micros / MICROS_PER_SECOND % 60),
+              static_cast<int>(micros % MICROS_PER_SECOND / microsPerFraction[precision]),
+              precision);
+}
+
+int64_t datetimeToMicros(const Datetime &datetime) {
+  return (datetime.date.epoch - (int64_t)1) * MICROS_PER_DAY + timeToMicros(datetime.time);
+}
+
+Datetime microsToDatetime(int64_t micros, int precision) {
+  int epoch = microsToEpoch(micros);
+
+  return Datetime(Date(epoch), microsToTime(micros - (epoch - (int64_t)1) * MICROS_PER_DAY, precision));
+}
+
+////// Calendar helpers
+// Day numbers are moved up one 400 year cycle and counted from March 1st, so the
+// leap day is the last day of its year and every division is on non negative values
+constexpr int DAYS_PER_ERA = 146097;
+
+// Day number of 0000-03-01
+constexpr int YEAR_0_MARCH_1 = -305;
+
+// Year and month, day and day of the year counted from March 1st (0 based)
+struct ShiftedCivil {
+  int year;
+  int month;
+  int day;
+  int dayOfYear;
+};
+
+inline ShiftedCivil shiftedCivil(const int epoch) {
+  const unsigned days = epoch - YEAR_0_MARCH_1 + DAYS_PER_ERA;
+  const unsigned era = days / DAYS_PER_ERA;
+  const unsigned dayOfEra = days - era * DAYS_PER_ERA;
+
+  // Every 4, 100 and 400 years a leap day shifts the year boundaries
+  const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+
+  // Months from March repeat a 153 days pattern every 5 months
+  const unsigned monthFromMarch = (5 * dayOfYear + 2) / 153;
+
+  ShiftedCivil civil;
+  civil.day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+  civil.month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+  civil.year = static_cast<int>(era * 400 + yearOfEra) - 400 + (civil.month <= 2);
+  civil.dayOfYear = dayOfYear;
+
+  return civil;
+}
+
+int civilToEpoch(const int year, const int month, const int day) {
+  const unsigned shiftedYear = year + 400 - (month <= 2);
+  const unsigned era = shiftedYear / 400;
+  const unsigned yearOfEra = shiftedYear - era * 400;
+
+  const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+  return static_cast<int>(era * DAYS_PER_ERA + dayOfEra) - DAYS_PER_ERA + YEAR_0_MARCH_1;
+}
+
+void epochToCivil(const int epoch, int &year, int &month, int &day) {
+  ShiftedCivil civil = shiftedCivil(epoch);
+
+  year = civil.year;
+  month = civil.month;
+  day = civil.day;
+}
+
+// January and February close the shifted year, the rest is offset by them
+inline int dayOfYear(const ShiftedCivil &civil) {
+  if (civil.month <= 2) return civil.dayOfYear - 305;
+
+  bool leap = civil.year % 4 == 0 && (civil.year % 100 != 0 || civil.year % 400 == 0);
+  return civil.dayOfYear + 60 + leap;
+}
+
+inline int isoWeek(const int epoch) {
+  // 0001-01-01 was a Monday
+  const int weekday = ((epoch - 1) % 7 + 7) % 7;
+  const int thursday = epoch - weekday + 3;
+
+  ShiftedCivil civil = shiftedCivil(thursday);
+  return (dayOfYear(civil) - 1) / 7 + 1;
+}
+
+int extractEpoch(const int epoch, const DateComponents mode) {
+  int value;
+  extractEpochs(&epoch, 1, mode, &value);
+
+  return value;
+}
+
+void extractEpochs(const int32_t *epochs, const int count, const DateComponents mode, int32_t *out) {
+  switch (mode) {
+    case DateComponents::DAYS:
+      for (int i = 0; i < count; ++i) out[i] = shiftedCivil(epochs[i]).day;
       break;
-    }
-    case DateComponents::MONTHS: {
-      jumps = (rhs.date.year - lhs.date.year) * 12 + (rhs.date.month - lhs.date.month);
+
+    case DateComponents::MONTHS:
+      for (int i = 0; i < count; ++i) out[i] = shiftedCivil(epochs[i]).month;
       break;
-    }
-    case DateComponents::DAYS: {
-      jumps = rhs.date.epoch - lhs.date.epoch;
+
+    case DateComponents::YEARS:
+      for (int i = 0; i < count; ++i) out[i] = shiftedCivil(epochs[i]).year;
       break;
-    }
-    case DateComponents::WEEKS: {
-      jumps = (rhs.date.epoch - lhs.date.epoch) / 7;
+
+    case DateComponents::QUARTERS:
+      for (int i = 0; i < count; ++i) out[i] = (shiftedCivil(epochs[i]).month - 1) / 3 + 1;
+      break;
+
+    case DateComponents::DAYOFYEAR:
+      for (int i = 0; i < count; ++i) out[i] = dayOfYear(shiftedCivil(epochs[i]));
+      break;
+
+    case DateComponents::WEEKS:
+      for (int i = 0; i < count; ++i) out[i] = isoWeek(epochs[i]);
       break;
-    }
-    case DateComponents::QUARTERS: {
-      jumps = (rhs.date.year - lhs.date.year) * 4 + (rhs.date.month / 4 - lhs.date.month / 4) ;
-      break;  
-    }
   }
+}
 
-  return jumps;
+inline int daysInMonth(const int year, const int month) {
+  bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+  return daysPerMonth[month - 1] + (month == 2 && leap);
 }
 
-// If lhs < rhs, the value will be positive
-int dateDiff(const Datetime &lhs, const Datetime &rhs, const TimeComponents &mode) {
-  int jumps = 0;
-  int dateJumps = dateDiff(lhs, rhs, DateComponents::DAYS);
+int addToEpoch(const int epoch, const int difference, const DateComponents mode) {
+  int months;
 
   switch (mode) {
-    case TimeComponents::HOURS: {
-      jumps = rhs.time.hour - lhs.time.hour + dateJumps * 24;
-      break;
-    }
-    case TimeComponents::MINUTES: {
-      jumps = rhs.time.minute - lhs.time.minute + ((rhs.time.hour - lhs.time.hour) + dateJumps * 24) * 60;
-      break;
-    }
-    case TimeComponents::SECONDS: {
-      jumps = rhs.time.second - lhs.time.second + ((rhs.time.minute - lhs.time.minute) + 
-        ((rhs.time.hour - lhs.time.hour) + dateJumps * 24) * 60) * 60;
-      break;
-    }
+    case DateComponents::DAYS:
+    case DateComponents::DAYOFYEAR: return epoch + difference;
+    case DateComponents::WEEKS: return epoch + difference * 7;
+    case DateComponents::MONTHS: months = difference; break;
+    case DateComponents::QUARTERS: months = difference * 3; break;
+    case DateComponents::YEARS: months = difference * 12; break;
+    default: return epoch; // Should never reach here
   }
 
-  return jumps;
+  ShiftedCivil civil = shiftedCivil(epoch);
+
+  // Months since year 0, floored so going back past it still lands on a real month
+  int total = civil.year * 12 + civil.month - 1 + months;
+  int year = total >= 0 ? total / 12 : (total - 11) / 12;
+  int month = total - year * 12 + 1;
+
+  return civilToEpoch(year, month, std::min(civil.day, daysInMonth(year, month)));
+}
+
+int epochDiff(const int from, const int to, const DateComponents mode) {
+  switch (mode) {
+    case DateComponents::DAYS:
+    case DateComponents::DAYOFYEAR: return to - from;
+    case DateComponents::WEEKS: return (to - from) / 7;
+    default: break;
+  }
+
+  ShiftedCivil lhs = shiftedCivil(from);
+  ShiftedCivil rhs = shiftedCivil(to);
+
+  switch (mode) {
+    case DateComponents::MONTHS: return (rhs.year - lhs.year) * 12 + (rhs.month - lhs.month);
+    case DateComponents::QUARTERS: return (rhs.year - lhs.year) * 4 + (rhs.month - 1) / 3 - (lhs.month - 1) / 3;
+    case DateComponents::YEARS: return rhs.year - lhs.year;
+    default: return 0; // Should never reach here
+  }
+}
+
+int bucketEpoch(const int epoch, const int width, const DateComponents mode) {
+  int months;
+
+  switch (mode) {
+    case DateComponents::DAYS:
+    case DateComponents::DAYOFYEAR: return roundDown(epoch - 1, width) + 1;
+    case DateComponents::WEEKS: return roundDown(epoch - 1, width * (int64_t)7) + 1;
+    case DateComponents::MONTHS: months = width; break;
+    case DateComponents::QUARTERS: months = width * 3; break;
+    case DateComponents::YEARS: months = width * 12; break;
+    default: return epoch; // Should never reach here
+  }
+
+  ShiftedCivil civil = shiftedCivil(epoch);
+
+  // Months since 0001-01
+  int bucket = roundDown((civil.year - 1) * 12 + civil.month - 1, months);
+  int years = roundDown(bucket, 12) / 12;
+
+  return civilToEpoch(years + 1, bucket - years * 12 + 1, 1);
+}
+
+int64_t roundDown(const int64_t value, const int64_t width) {
+  int64_t quotient = value / width;
+  if (value % width < 0) --quotient;
+
+  return quotient * width;
+}
+
+int microsToEpoch(const int64_t micros) {
+  // Floor division, so instants before 0001-01-01 still land on the right day
+  int64_t days = micros / MICROS_PER_DAY;
+  if (micros % MICROS_PER_DAY < 0) --days;
+
+  return static_cast<int>(days + 1);
+}
+
+int64_t microsOfDay(const int64_t micros) {
+  int64_t sinceMidnight = micros % MICROS_PER_DAY;
+  return sinceMidnight < 0 ? sinceMidnight + MICROS_PER_DAY : sinceMidnight;
 }
 
 ///////////////////////// End Datetime ////////////////////////////////////
@@ -712,6 +778,8 @@ ostream& operator<<(ostream& os, const Varchar& self){
 
 ostream& operator<<(ostream& os, const SQLChar& self){
   os << self.value;
+  for (int i = self.value.size(); i < self.length; ++i) os << ' ';
+
   return os;
 }
 
@@ -809,6 +877,13 @@ Varchar::operator string () const {
   return value;
 }
 
+SQLChar::operator string () const {
+  string padded = value;
+  if (static_cast<int>(padded.size()) < length) padded.resize(length, ' ');
+
+  return padded;
+}
+
 /////////////////////// Misc operators end //////////////////////////////
 
 
@@ -988,27 +1063,27 @@ bool operator>=(const string &lhs, const Varchar &rhs) {
 
 ///// SQLChar vs. SQLChar
 bool SQLChar::operator==(const SQLChar &rhs) const {
-  return comparatorHelper(value, rhs.value, std::equal_to<>{});
+  return std::equal_to<>{}(comparePadded(value, rhs.value), 0);
 }
 
 bool SQLChar::operator!=(const SQLChar &rhs) const {
-  return comparatorHelper(value, rhs.value, std::not_equal_to<>{});
+  return std::not_equal_to<>{}(comparePadded(value, rhs.value), 0);
 }
 
 bool SQLChar::operator<(const SQLChar &rhs) const {
-  return comparatorHelper(value, rhs.value, std::less<>{});
+  return std::less<>{}(comparePadded(value, rhs.value), 0);
 }
 
 bool SQLChar::operator>(const SQLChar &rhs) const {
-  return comparatorHelper(value, rhs.value, std::greater<>{});
+  return std::greater<>{}(comparePadded(value, rhs.value), 0);
 }
 
 bool SQLChar::operator<=(const SQLChar &rhs) const {
-  return comparatorHelper(value, rhs.value, std::less_equal<>{});
+  return std::less_equal<>{}(comparePadded(value, rhs.value), 0);
 }
 
 bool SQLChar::operator>=(const SQLChar &rhs) const {
-  return comparatorHelper(value, rhs.value, std::greater_equal<>{});
+  return std::greater_equal<>{}(comparePadded(value, rhs.value), 0);
 }
 
 
@@ -1,9 +1,11 @@
 #pragma once
 #include <unordered_map>
 #include <vector>
+#include <array>
 #include <variant>
 #include <cassert>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <compare>
 #include <iomanip>
@@ -80,6 +82,9 @@ class Varchar{
     virtual void enforceLengthInvariant();
 };
 
+// CHAR(n). Only the significant characters are kept in value (trailing spaces are
+// dropped on construction), the padding up to length is implied: comparisons between
+// CHARs behave as if both were padded, and output/string conversion pads on the fly
 class SQLChar : public Varchar {
   public:
     using Varchar::Varchar;
@@ -90,6 +95,12 @@ class SQLChar : public Varchar {
     SQLChar(int Length);
     SQLChar(int Length, string Value);
 
+    // Padded versions, the stored value is available through value
+    string getValue() const;
+    int getLength() const;
+
+    explicit operator string () const;
+
     // SQLChar(Table* table, std::string name);
     // SQLChar(Table* table, string name, string Value);
 
@@ -134,9 +145,16 @@ class SQLChar : public Varchar {
   private:
     void enforceLengthInvariant() override;
 
-    string getUnpaddedValue() const;
+    const string& getUnpaddedValue() const;
+
+    // Drops trailing spaces, they are implied by length
+    void trimPadding();
 };
 
+// Three way comparison of two CHAR values as if the shorter one was padded with
+// spaces up to the length of the other, without building the padding
+int comparePadded(string_view lhs, string_view rhs);
+
 constexpr array<int, 12> daysPerMonth = 
           {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
@@ -194,11 +212,6 @@ class Date {
 
     bool isLeapYear() const;
     bool isLeapYear(int const currentYear) const;
-    
-    // IMPORTANT: Does not consider the current year!
-    // if year = 4, there have been 0 up to today
-    int leapDaysUpToCurrentYear() const;
-    int leapDaysUpToCurrentYear(int const currentYear) const;
 
     // Takes the current epoch, and overwrites year, month, day
     // with what they should be
@@ -309,6 +322,63 @@ class Datetime {
 int dateDiff(const Datetime &rhs, const Datetime &lhs, const DateComponents &mode);
 int dateDiff(const Datetime &rhs, const Datetime &lhs, const TimeComponents &mode);
 
+////// Fixed point helpers: times as int64 microseconds
+constexpr int64_t MICROS_PER_SECOND = 1000000;
+constexpr int64_t MICROS_PER_MINUTE = 60 * MICROS_PER_SECOND;
+constexpr int64_t MICROS_PER_HOUR = 60 * MICROS_PER_MINUTE;
+constexpr int64_t MICROS_PER_DAY = 24 * MICROS_PER_HOUR;
+
+// Microseconds in one unit of mode (FRACTIONS are counted in microseconds)
+int64_t microsPerComponent(const TimeComponents mode);
+
+// Component of a microseconds since midnight value, same units as Time::extract
+int64_t extractMicros(const int64_t micros, const TimeComponents mode);
+
+////// Calendar helpers: dates as day numbers (Date::epoch, 0001-01-01 is day 1)
+// Proleptic Gregorian, in closed form through the 400 year cycle: no loop over
+// years or months
+int civilToEpoch(const int year, const int month, const int day);
+void epochToCivil(const int epoch, int &year, int &month, int &day);
+
+// Component of a day number, same values as Date::extract. WEEKS is the ISO 8601
+// week, which starts on Monday and is 1 for the week holding January's first Thursday
+int extractEpoch(const int epoch, const DateComponents mode);
+
+// out[i] = extractEpoch(epochs[i], mode) for i in [0, count), with the switch on
+// mode taken once for the whole array
+void extractEpochs(const int32_t *epochs, const int count, const DateComponents mode, int32_t *out);
+
+// Day number moved by difference units of mode (DAYOFYEAR counts as DAYS). MONTHS,
+// QUARTERS and YEARS keep the day of the month, clamped to the length of the month
+// landed on, so January 31st plus one month is the last day of February
+int addToEpoch(const int epoch, const int difference, const DateComponents mode);
+
+// Boundaries of mode crossed going from day number from to day number to, negative
+// when to comes first. WEEKS are whole 7 day spans
+int epochDiff(const int from, const int to, const DateComponents mode);
+
+// First day of the width units wide bucket holding a day number (DAYOFYEAR counts as
+// DAYS). Buckets are counted from 0001-01-01, which was a Monday, so week buckets
+// start on Mondays and month based ones on January 1st for widths dividing a year
+int bucketEpoch(const int epoch, const int width, const DateComponents mode);
+
+// Largest multiple of width (> 0) that is not above value
+int64_t roundDown(const int64_t value, const int64_t width);
+
+// Day number of a microseconds since 0001-01-01 00:00:00 value (DATETIME storage)
+int microsToEpoch(const int64_t micros);
+
+// Microseconds since midnight of the same value, never negative
+int64_t microsOfDay(const int64_t micros);
+
+// Microseconds since midnight
+int64_t timeToMicros(const Time &time);
+Time microsToTime(int64_t micros, int precision=6);
+
+// Microseconds since 0001-01-01 00:00:00
+int64_t datetimeToMicros(const Datetime &datetime);
+Datetime microsToDatetime(int64_t micros, int precision=6);
+
 /////////////////// Types helper functions ////////////////////////////////////////
 
 // Defining a type trait for string-like classes
@@ -492,6 +562,38 @@ ostream& operator<<(ostream& os, const Types& self);
 
 bool isNull(const Types &value);
 
+// Hashes that agree with the comparison operators: values that compare equal hash
+// equal. Characters are hashed without trailing spaces, which CHAR comparisons ignore
+size_t hashCharacters(string_view value);
+
+namespace std {
+  template <>
+  struct hash<Varchar> {size_t operator()(const Varchar &value) const;};
+
+  template <>
+  struct hash<SQLChar> {size_t operator()(const SQLChar &value) const;};
+
+  template <>
+  struct hash<Date> {size_t operator()(const Date &value) const;};
+
+  template <>
+  struct hash<Time> {size_t operator()(const Time &value) const;};
+
+  template <>
+  struct hash<Datetime> {size_t operator()(const Datetime &value) const;};
+}
+
+// For hash containers of Types. Numbers hash by their value as a double, since mixed
+// numbers compare as doubles. NULLs are equal to each other here (as they are
+// equivalent in a set<Types>), even though NULL == NULL is false
+struct TypesHash {
+  size_t operator()(const Types &value) const;
+};
+
+struct TypesEqual {
+  bool operator()(const Types &lhs, const Types &rhs) const;
+};
+
 
 /////////////// Comparator hell part 2 ////////////////////////////
 ////// Types vs. Types
@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <type_traits>
+
+using namespace std;
+
+// Dictionary encoded buffer for low cardinality string columns. Every distinct
+// value is stored once in entries, and each cell is just an index (code) into it.
+// Exposes the same surface as the vector buffers (value_type, operator[], push_back...)
+// so column kernels can treat both alike
+template <typename T>
+class Dictionary {
+  public:
+    using value_type = T;
+
+    // VARCHAR and CHAR entries are given the column's declared length, -1 for none
+    Dictionary(const int CharLength=-1) : charLength(CharLength) {}
+
+    int size() const {
+      return codes.size();
+    }
+
+    void reserve(int capacity) {
+      codes.reserve(capacity);
+    }
+
+    const T& operator[] (int index) const {
+      return entries[codes[index]];
+    }
+
+    void push_back(const T &value) {
+      codes.push_back(encode(value));
+    }
+
+    void set(int index, const T &value) {
+      codes[index] = encode(value);
+    }
+
+    void pop_back() {
+      codes.pop_back();
+    }
+
+    void erase(int index) {
+      codes.erase(codes.begin() + index);
+    }
+
+    // Code of the text value (unpadded for CHAR), or -1 if it never made it into
+    // the dictionary
+    int find(const string &value) const {
+      auto found = lookup.find(value);
+      return found == lookup.end() ? -1 : found->second;
+    }
+
+    // Entries are never dropped when cells go away, so some may be unused
+    const vector<T>& getEntries() const {
+      return entries;
+    }
+
+    const vector<int>& getCodes() const {
+      return codes;
+    }
+
+  private:
+    vector<T> entries;
+    vector<int> codes;
+    unordered_map<string, int> lookup;
+    int charLength;
+
+    // VARCHAR and CHAR values are keyed by their characters alone, so CHAR values
+    // padded to different lengths are the same entry
+    static const string& key(const T &value) {
+      if constexpr (is_same_v<T, string>) return value;
+      else return value.value;
+    }
+
+    int encode(const T &value) {
+      auto [found, inserted] = lookup.try_emplace(key(value), entries.size());
+      if (inserted) entries.push_back(rebuilt(value));
+
+      return found->second;
+    }
+
+    // Entries are rebuilt around the column's length, as CharArena does its cells
+    T rebuilt(const T &value) const {
+      if constexpr (is_same_v<T, string>) return value;
+      else {
+        T entry;
+        entry.value = value.value;
+        entry.length = charLength == -1 ? entry.value.size() : charLength;
+
+        return entry;
+      }
+    }
+};
+
+template <typename T>
+struct is_dictionary : std::false_type {};
+
+template <typename T>
+struct is_dictionary<Dictionary<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_dictionary_v = is_dictionary<T>::value;
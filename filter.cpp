@@ -0,0 +1,236 @@
+#include "filter.h"
+#include <algorithm>
+
+// The AVX2 kernels are compiled for AVX2 regardless of the build flags, and only
+// picked at runtime when the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_AVX2 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <CompareOp Op, typename T>
+inline bool compare(const T lhs, const T rhs) {
+  if constexpr (Op == CompareOp::EQ) return lhs == rhs;
+  else if constexpr (Op == CompareOp::NE) return lhs != rhs;
+  else if constexpr (Op == CompareOp::LT) return lhs < rhs;
+  else if constexpr (Op == CompareOp::LE) return lhs <= rhs;
+  else if constexpr (Op == CompareOp::GT) return lhs > rhs;
+  else return lhs >= rhs;
+}
+
+// Handles values [first, count), first has to be a multiple of 64
+template <CompareOp Op, typename T>
+void compareScalar(const T *values, const int first, const int count, const T value, uint64_t *out) {
+  for (int base = first; base < count; base += 64) {
+    int end = std::min(64, count - base);
+    uint64_t word = 0;
+
+    for (int bit = 0; bit < end; ++bit) {
+      word |= static_cast<uint64_t>(compare<Op>(values[base + bit], value)) << bit;
+    }
+
+    out[base / 64] = word;
+  }
+}
+
+#ifdef FILTER_AVX2
+
+// Per type AVX2 operations. compare<Op> returns one bit per lane, lane 0 lowest
+template <typename T>
+struct Avx2Lanes;
+
+// Integers only have == and >, the other comparisons are derived from those
+template <typename Self>
+struct IntegerLanes {
+  template <CompareOp Op, typename Vector>
+  TARGET_AVX2 static uint64_t compare(const Vector lhs, const Vector rhs) {
+    constexpr uint64_t lanes = (uint64_t(1) << Self::count) - 1;
+
+    if constexpr (Op == CompareOp::EQ) return Self::eq(lhs, rhs);
+    else if constexpr (Op == CompareOp::NE) return ~Self::eq(lhs, rhs) & lanes;
+    else if constexpr (Op == CompareOp::LT) return Self::gt(rhs, lhs);
+    else if constexpr (Op == CompareOp::LE) return ~Self::gt(lhs, rhs) & lanes;
+    else if constexpr (Op == CompareOp::GT) return Self::gt(lhs, rhs);
+    else return ~Self::gt(rhs, lhs) & lanes;
+  }
+};
+
+// Bytes are unsigned, flipping the sign bit makes the signed comparison order them right
+template <>
+struct Avx2Lanes<uint8_t> : IntegerLanes<Avx2Lanes<uint8_t>> {
+  static constexpr int count = 32;
+
+  TARGET_AVX2 static __m256i broadcast(const uint8_t value) {
+    return _mm256_set1_epi8(static_cast<char>(value ^ 0x80));
+  }
+
+  TARGET_AVX2 static __m256i load(const uint8_t *values) {
+    __m256i loaded = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    return _mm256_xor_si256(loaded, _mm256_set1_epi8(static_cast<char>(0x80)));
+  }
+
+  TARGET_AVX2 static uint64_t eq(const __m256i lhs, const __m256i rhs) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs, rhs)));
+  }
+
+  TARGET_AVX2 static uint64_t gt(const __m256i lhs, const __m256i rhs) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(lhs, rhs)));
+  }
+};
+
+template <>
+struct Avx2Lanes<int16_t> : IntegerLanes<Avx2Lanes<int16_t>> {
+  static constexpr int count = 16;
+
+  TARGET_AVX2 static __m256i broadcast(const int16_t value) {
+    return _mm256_set1_epi16(value);
+  }
+
+  TARGET_AVX2 static __m256i load(const int16_t *values) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+  }
+
+  // movemask works on bytes, so the 16 bit masks are packed down to bytes first. Packing
+  // works per 128 bit half, which leaves lanes 0-7 in bits 0-7 and lanes 8-15 in bits 16-23
+  TARGET_AVX2 static uint64_t toBits(const __m256i mask) {
+    uint32_t bytes = _mm256_movemask_epi8(_mm256_packs_epi16(mask, mask));
+    return (bytes & 0xFF) | ((bytes >> 8) & 0xFF00);
+  }
+
+  TARGET_AVX2 static uint64_t eq(const __m256i lhs, const __m256i rhs) {
+    return toBits(_mm256_cmpeq_epi16(lhs, rhs));
+  }
+
+  TARGET_AVX2 static uint64_t gt(const __m256i lhs, const __m256i rhs) {
+    return toBits(_mm256_cmpgt_epi16(lhs, rhs));
+  }
+};
+
+template <>
+struct Avx2Lanes<int32_t> : IntegerLanes<Avx2Lanes<int32_t>> {
+  static constexpr int count = 8;
+
+  TARGET_AVX2 static __m256i broadcast(const int32_t value) {
+    return _mm256_set1_epi32(value);
+  }
+
+  TARGET_AVX2 static __m256i load(const int32_t *values) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+  }
+
+  TARGET_AVX2 static uint64_t eq(const __m256i lhs, const __m256i rhs) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lhs, rhs)));
+  }
+
+  TARGET_AVX2 static uint64_t gt(const __m256i lhs, const __m256i rhs) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(lhs, rhs)));
+  }
+};
+
+template <>
+struct Avx2Lanes<int64_t> : IntegerLanes<Avx2Lanes<int64_t>> {
+  static constexpr int count = 4;
+
+  TARGET_AVX2 static __m256i broadcast(const int64_t value) {
+    return _mm256_set1_epi64x(value);
+  }
+
+  TARGET_AVX2 static __m256i load(const int64_t *values) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+  }
+
+  TARGET_AVX2 static uint64_t eq(const __m256i lhs, const __m256i rhs) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lhs, rhs)));
+  }
+
+  TARGET_AVX2 static uint64_t gt(const __m256i lhs, const __m256i rhs) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(lhs, rhs)));
+  }
+};
+
+// Ordered predicates, except != which has to hold for NaN
+template <>
+struct Avx2Lanes<float> {
+  static constexpr int count = 8;
+
+  TARGET_AVX2 static __m256 broadcast(const float value) {
+    return _mm256_set1_ps(value);
+  }
+
+  TARGET_AVX2 static __m256 load(const float *values) {
+    return _mm256_loadu_ps(values);
+  }
+
+  template <CompareOp Op>
+  TARGET_AVX2 static uint64_t compare(const __m256 lhs, const __m256 rhs) {
+    if constexpr (Op == CompareOp::EQ) return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ));
+    else if constexpr (Op == CompareOp::NE) return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_NEQ_UQ));
+    else if constexpr (Op == CompareOp::LT) return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ));
+    else if constexpr (Op == CompareOp::LE) return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_LE_OQ));
+    else if constexpr (Op == CompareOp::GT) return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ));
+    else return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_GE_OQ));
+  }
+};
+
+// Full words go through the vector lanes, the tail through the scalar loop
+template <CompareOp Op, typename T>
+TARGET_AVX2 void compareAvx2(const T *values, const int count, const T value, uint64_t *out) {
+  using Lanes = Avx2Lanes<T>;
+  const auto rhs = Lanes::broadcast(value);
+  const int fullWords = count / 64;
+
+  for (int w = 0; w < fullWords; ++w) {
+    uint64_t word = 0;
+
+    for (int lane = 0; lane < 64; lane += Lanes::count) {
+      auto lhs = Lanes::load(values + w * 64 + lane);
+      word |= Lanes::template compare<Op>(lhs, rhs) << lane;
+    }
+
+    out[w] = word;
+  }
+
+  compareScalar<Op>(values, fullWords * 64, count, value, out);
+}
+
+bool hasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+#endif
+
+template <CompareOp Op, typename T>
+void dispatch(const T *values, const int count, const T value, uint64_t *out) {
+#ifdef FILTER_AVX2
+  if (hasAvx2()) {
+    compareAvx2<Op>(values, count, value, out);
+    return;
+  }
+#endif
+
+  compareScalar<Op>(values, 0, count, value, out);
+}
+
+} // namespace
+
+template <typename T>
+void compareValues(const T *values, int count, T value, CompareOp op, uint64_t *out) {
+  switch (op) {
+    case CompareOp::EQ: return dispatch<CompareOp::EQ>(values, count, value, out);
+    case CompareOp::NE: return dispatch<CompareOp::NE>(values, count, value, out);
+    case CompareOp::LT: return dispatch<CompareOp::LT>(values, count, value, out);
+    case CompareOp::LE: return dispatch<CompareOp::LE>(values, count, value, out);
+    case CompareOp::GT: return dispatch<CompareOp::GT>(values, count, value, out);
+    case CompareOp::GE: return dispatch<CompareOp::GE>(values, count, value, out);
+  }
+}
+
+template void compareValues<uint8_t>(const uint8_t *, int, uint8_t, CompareOp, uint64_t *);
+template void compareValues<int16_t>(const int16_t *, int, int16_t, CompareOp, uint64_t *);
+template void compareValues<int32_t>(const int32_t *, int, int32_t, CompareOp, uint64_t *);
+template void compareValues<int64_t>(const int64_t *, int, int64_t, CompareOp, uint64_t *);
+template void compareValues<float>(const float *, int, float, CompareOp, uint64_t *);
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+using namespace std;
+
+enum class CompareOp {EQ, NE, LT, LE, GT, GE};
+
+// Predicate kernel: sets bit i of out to (values[i] op value) for every i < count,
+// 64 values per output word. out needs room for (count + 63) / 64 words, bits past
+// count in the last word are left at 0.
+// On x86 CPUs with AVX2 the comparisons run 4 to 32 values at a time (depending on
+// the width of T), everything else goes through a branch free scalar loop.
+// Floats follow C++ semantics for NaN: only != holds
+template <typename T>
+void compareValues(const T *values, int count, T value, CompareOp op, uint64_t *out);
+
+extern template void compareValues<uint8_t>(const uint8_t *, int, uint8_t, CompareOp, uint64_t *);
+extern template void compareValues<int16_t>(const int16_t *, int, int16_t, CompareOp, uint64_t *);
+extern template void compareValues<int32_t>(const int32_t *, int, int32_t, CompareOp, uint64_t *);
+extern template void compareValues<int64_t>(const int64_t *, int, int64_t, CompareOp, uint64_t *);
+extern template void compareValues<float>(const float *, int, float, CompareOp, uint64_t *);
@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+
+// Open addressing hash set with linear probing, for the distinct style operations.
+// Values and their hashes sit in flat arrays (no node per value), probes compare
+// the stored hash before the values, and the table doubles once it is half full so
+// probe runs stay short. Hashes are scrambled before picking a slot, so identity
+// hashes (std::hash<int>) of patterned keys don't pile up in one run.
+// Only grows: there is no erase
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class HashSet {
+  public:
+    HashSet(int expected=0) {
+      reserve(expected);
+    }
+
+    int size() const {
+      return count;
+    }
+
+    bool empty() const {
+      return count == 0;
+    }
+
+    // Makes room for expected values without rehashing
+    void reserve(int expected) {
+      int needed = MIN_SLOTS;
+      while (needed < expected * 2) needed *= 2;
+
+      if (needed > static_cast<int>(slots.size())) rehash(needed);
+    }
+
+    // Returns true if value was not in the set before
+    bool insert(const T &value) {
+      if ((count + 1) * 2 > static_cast<int>(slots.size())) rehash(std::max<int>(MIN_SLOTS, slots.size() * 2));
+
+      uint64_t hashed = hashOf(value);
+      size_t slot = find(value, hashed);
+
+      if (hashes[slot] != EMPTY) return false;
+
+      hashes[slot] = hashed;
+      slots[slot] = value;
+      ++count;
+
+      return true;
+    }
+
+    bool contains(const T &value) const {
+      if (count == 0) return false;
+
+      return hashes[find(value, hashOf(value))] != EMPTY;
+    }
+
+    // Calls func(value) on every value, in no particular order
+    template <typename Func>
+    void forEach(Func &&func) const {
+      for (size_t slot = 0; slot < slots.size(); ++slot) {
+        if (hashes[slot] != EMPTY) func(slots[slot]);
+      }
+    }
+
+  private:
+    static constexpr int MIN_SLOTS = 16;
+
+    // Hashes are forced odd, so 0 can mark a free slot
+    static constexpr uint64_t EMPTY = 0;
+
+    vector<T> slots;
+    vector<uint64_t> hashes;
+    int count = 0;
+    int shift = 64;
+
+    Hash hash;
+    Equal equal;
+
+    uint64_t hashOf(const T &value) const {
+      return static_cast<uint64_t>(hash(value)) | 1;
+    }
+
+    // Fibonacci hashing: the top bits of the product depend on every bit of the hash
+    size_t home(const uint64_t hashed) const {
+      return (hashed * 0x9E3779B97F4A7C15ull) >> shift;
+    }
+
+    // Slot holding value, or the free slot where it would go
+    size_t find(const T &value, const uint64_t hashed) const {
+      const size_t mask = slots.size() - 1;
+      size_t slot = home(hashed);
+
+      while (hashes[slot] != EMPTY && !(hashes[slot] == hashed && equal(slots[slot], value))) {
+        slot = (slot + 1) & mask;
+      }
+
+      return slot;
+    }
+
+    void rehash(const int capacity) {
+      vector<T> oldSlots(capacity);
+      vector<uint64_t> oldHashes(capacity, EMPTY);
+      oldSlots.swap(slots);
+      oldHashes.swap(hashes);
+
+      shift = 64 - __builtin_ctzll(capacity);
+
+      const size_t mask = capacity - 1;
+      for (size_t slot = 0; slot < oldSlots.size(); ++slot) {
+        if (oldHashes[slot] == EMPTY) continue;
+
+        size_t target = home(oldHashes[slot]);
+        while (hashes[target] != EMPTY) target = (target + 1) & mask;
+
+        hashes[target] = oldHashes[slot];
+        slots[target] = std::move(oldSlots[slot]);
+      }
+    }
+};
@@ -0,0 +1,74 @@
+#include "hyperloglog.h"
+#include <iostream>
+#include <cmath>
+
+/////////////////////////// HyperLogLog /////////////////////////////////
+
+HyperLogLog::HyperLogLog(int Precision) : precision(Precision) {
+  if (precision < MIN_PRECISION || precision > MAX_PRECISION) {
+    cerr << "HyperLogLog precision must be between " << MIN_PRECISION << " and " << MAX_PRECISION << endl;
+    exit(3);
+  }
+
+  registers.assign(size_t(1) << precision, 0);
+}
+
+// splitmix64's finalizer, so every input bit reaches the register index and the rank
+void HyperLogLog::add(uint64_t hash) {
+  hash ^= hash >> 30;
+  hash *= 0xBF58476D1CE4E5B9ull;
+  hash ^= hash >> 27;
+  hash *= 0x94D049BB133111EBull;
+  hash ^= hash >> 31;
+
+  size_t index = hash >> (64 - precision);
+  uint64_t rest = hash << precision;
+
+  uint8_t rank = rest ? __builtin_clzll(rest) + 1 : 64 - precision + 1;
+  if (rank > registers[index]) registers[index] = rank;
+}
+
+void HyperLogLog::merge(const HyperLogLog &other) {
+  if (other.precision != precision) {
+    cerr << "Only sketches of the same precision can be merged" << endl;
+    exit(3);
+  }
+
+  for (size_t i = 0; i < registers.size(); ++i) {
+    if (other.registers[i] > registers[i]) registers[i] = other.registers[i];
+  }
+}
+
+// Harmonic mean of the registers, with linear counting while many are still empty.
+// 64 bit hashes don't need the large range correction of the original paper
+double HyperLogLog::estimate() const {
+  const double m = registers.size();
+
+  double alpha;
+  switch (precision) {
+    case 4: alpha = 0.673; break;
+    case 5: alpha = 0.697; break;
+    case 6: alpha = 0.709; break;
+    default: alpha = 0.7213 / (1 + 1.079 / m);
+  }
+
+  double inverseSum = 0;
+  int zeros = 0;
+
+  for (uint8_t rank : registers) {
+    inverseSum += std::ldexp(1.0, -rank);
+    zeros += rank == 0;
+  }
+
+  double raw = alpha * m * m / inverseSum;
+
+  if (raw <= 2.5 * m && zeros > 0) return m * std::log(m / zeros);
+
+  return raw;
+}
+
+int HyperLogLog::getPrecision() const {
+  return precision;
+}
+
+///////////////////////// HyperLogLog end ///////////////////////////////
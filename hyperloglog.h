@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// HyperLogLog sketch for approximate distinct counts. Each value's hash picks one of
+// 2^precision registers, which keeps the longest run of leading zeros seen in the
+// rest of the hash. Memory is one byte per register whatever the number of values,
+// and the relative error is about 1.04 / sqrt(2^precision): 0.8% at the default 14.
+// Sketches of the same precision merge into the sketch of the union of their values,
+// so partial sketches (per segment, per thread, per table...) can be combined
+class HyperLogLog {
+  public:
+    static constexpr int MIN_PRECISION = 4;
+    static constexpr int MAX_PRECISION = 18;
+    static constexpr int DEFAULT_PRECISION = 14;
+
+    HyperLogLog(int Precision=DEFAULT_PRECISION);
+
+    // hash does not have to be well mixed (std::hash<int> is the identity), it is
+    // scrambled again before use
+    void add(uint64_t hash);
+    void merge(const HyperLogLog &other);
+
+    double estimate() const;
+    int getPrecision() const;
+
+  private:
+    int precision;
+    vector<uint8_t> registers;
+};
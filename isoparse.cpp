@@ -0,0 +1,179 @@
+#include "isoparse.h"
+#include "datatypes.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Lanes (bytes) of the first 8 characters of YYYY-MM-DD and HH:MM:SS holding digits,
+// the first character in the lowest byte
+constexpr uint64_t DATE_DIGITS = 0x00FFFF00FFFFFFFFull;
+constexpr uint64_t TIME_DIGITS = 0xFFFF00FFFF00FFFFull;
+
+uint64_t load8(const char *bytes) {
+  uint64_t word;
+  memcpy(&word, bytes, sizeof(word));
+
+  return word;
+}
+
+// True if every lane of word in mask holds an ASCII digit: the high nibble is 3, and
+// stays 3 once 6 is added to the low one. Only masked lanes get the 6, so no carry
+// crosses into a neighbour. Lanes count from the lowest byte, as on little endian CPUs
+bool allDigits(const uint64_t word, const uint64_t mask) {
+  const uint64_t high = 0xF0F0F0F0F0F0F0F0ull & mask;
+  const uint64_t expected = 0x3030303030303030ull & mask;
+
+  return (word & high) == expected && ((word + (0x0606060606060606ull & mask)) & high) == expected;
+}
+
+int digit(const char c) {
+  return c - '0';
+}
+
+int twoDigits(const char *bytes) {
+  return digit(bytes[0]) * 10 + digit(bytes[1]);
+}
+
+// Parses 1 to maxDigits digits at text[position], and moves position past them
+bool parseField(string_view text, size_t &position, const size_t maxDigits, int &value) {
+  if (position >= text.size() || text[position] < '0' || text[position] > '9') return false;
+
+  const char *first = text.data() + position;
+  const char *last = text.data() + std::min(text.size(), position + maxDigits);
+
+  auto [end, error] = from_chars(first, last, value);
+  if (error != errc()) return false;
+
+  position += end - first;
+  return true;
+}
+
+bool expect(string_view text, size_t &position, const char separator) {
+  if (position >= text.size() || text[position] != separator) return false;
+
+  ++position;
+  return true;
+}
+
+bool validDate(const int year, const int month, const int day) {
+  if (year < 0 || year > 9999 || month < 1 || month > 12 || day < 1) return false;
+
+  bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+  return day <= daysPerMonth[month - 1] + (month == 2 && leap);
+}
+
+// Date at the start of text, position ends up right after it
+bool parseDatePart(string_view text, size_t &position, int32_t &epoch) {
+  int year, month, day;
+
+  if (isFixedWidthDate(text)) {
+    year = twoDigits(text.data()) * 100 + twoDigits(text.data() + 2);
+    month = twoDigits(text.data() + 5);
+    day = twoDigits(text.data() + 8);
+    position = 10;
+  }
+  else {
+    position = 0;
+
+    if (!parseField(text, position, 4, year) || !expect(text, position, '-') ||
+        !parseField(text, position, 2, month) || !expect(text, position, '-') ||
+        !parseField(text, position, 2, day)) {
+      return false;
+    }
+  }
+
+  if (!validDate(year, month, day)) return false;
+
+  epoch = civilToEpoch(year, month, day);
+  return true;
+}
+
+bool parseTimePart(string_view text, int64_t &micros, const int precision) {
+  int hour, minute, second;
+  size_t position = 0;
+
+  if (isFixedWidthTime(text)) {
+    hour = twoDigits(text.data());
+    minute = twoDigits(text.data() + 3);
+    second = twoDigits(text.data() + 6);
+    position = 8;
+  }
+  else if (!parseField(text, position, 2, hour) || !expect(text, position, ':') ||
+           !parseField(text, position, 2, minute) || !expect(text, position, ':') ||
+           !parseField(text, position, 2, second)) {
+    return false;
+  }
+
+  if (hour > 23 || minute > 59 || second > 59) return false;
+
+  // Up to 6 digits are microseconds, the others are dropped
+  int64_t fraction = 0;
+  int64_t scale = MICROS_PER_SECOND;
+
+  if (position < text.size() && text[position] == '.') {
+    size_t first = ++position;
+
+    for (; position < text.size() && text[position] >= '0' && text[position] <= '9'; ++position) {
+      if (scale == 1) continue;
+
+      scale /= 10;
+      fraction += digit(text[position]) * scale;
+    }
+
+    if (position == first) return false;
+  }
+
+  if (position != text.size()) return false;
+
+  // Cut down to precision
+  int64_t unit = 1;
+  for (int i = std::max(0, std::min(precision, 6)); i < 6; ++i) unit *= 10;
+
+  micros = (hour * (int64_t)3600 + minute * 60 + second) * MICROS_PER_SECOND + fraction / unit * unit;
+  return true;
+}
+
+}
+
+bool isFixedWidthDate(string_view text) {
+  return text.size() >= 10 && allDigits(load8(text.data()), DATE_DIGITS) && text[4] == '-' && text[7] == '-' &&
+         allDigits(load8(text.data() + 2), 0xFFFF000000000000ull);
+}
+
+bool isFixedWidthTime(string_view text) {
+  return text.size() >= 8 && allDigits(load8(text.data()), TIME_DIGITS) && text[2] == ':' && text[5] == ':';
+}
+
+bool parseIsoDate(string_view text, int32_t &epoch) {
+  size_t position;
+  int32_t parsed;
+
+  if (!parseDatePart(text, position, parsed) || position != text.size()) return false;
+
+  epoch = parsed;
+  return true;
+}
+
+bool parseIsoTime(string_view text, int64_t &micros, const int precision) {
+  return parseTimePart(text, micros, precision);
+}
+
+bool parseIsoDatetime(string_view text, int64_t &micros, const int precision) {
+  size_t position;
+  int32_t epoch;
+
+  if (!parseDatePart(text, position, epoch)) return false;
+
+  if (!text.empty() && text.back() == 'Z' && position < text.size()) text.remove_suffix(1);
+
+  int64_t sinceMidnight = 0;
+
+  if (position != text.size()) {
+    if (text[position] != 'T' && text[position] != ' ') return false;
+    if (!parseTimePart(text.substr(position + 1), sinceMidnight, precision)) return false;
+  }
+
+  micros = (epoch - (int64_t)1) * MICROS_PER_DAY + sinceMidnight;
+  return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+// Parsers for ISO 8601 literals, straight into the packed forms (see Packing): day
+// numbers for dates, microseconds for times and timestamps. Nothing is allocated.
+// Fixed width fields (YYYY-MM-DD, HH:MM:SS) have their digits checked 8 bytes at a
+// time in a 64 bit word, and are converted without a branch per digit. Anything else,
+// like single digit fields, goes field by field through from_chars.
+// They return false on malformed or out of range input, and leave the result untouched
+
+// True if text starts with YYYY-MM-DD (or HH:MM:SS), digits where they should be: the
+// parsers then take the 8 bytes at a time path
+bool isFixedWidthDate(string_view text);
+bool isFixedWidthTime(string_view text);
+
+// YYYY-MM-DD, fields may be shorter (2024-1-5). Years go from 0 to 9999
+bool parseIsoDate(string_view text, int32_t &epoch);
+
+// HH:MM:SS[.fraction], fields may be shorter. Fraction digits past precision are dropped
+bool parseIsoTime(string_view text, int64_t &micros, const int precision=6);
+
+// A date, then a time after 'T' or ' ', with an optional trailing 'Z'. A lone date
+// is midnight
+bool parseIsoDatetime(string_view text, int64_t &micros, const int precision=6);
@@ -0,0 +1,151 @@
+#include "like.h"
+#include "textcase.h"
+#include <iostream>
+#include <cstring>
+
+/////////////////////////// LikePattern ////////////////////////////////////
+
+LikePattern::LikePattern(const string &pattern, const bool CaseInsensitive, const char escape) :
+  caseInsensitive(CaseInsensitive) {
+  pieces.emplace_back();
+
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    char c = pattern[i];
+
+    if (c == '%') {
+      if (i == 0) anchoredStart = false;
+      if (i + 1 == pattern.size()) anchoredEnd = false;
+
+      // Runs of % are the same as a single one
+      if (!pieces.back().bytes.empty()) pieces.emplace_back();
+      continue;
+    }
+
+    bool wildcard = c == '_';
+
+    if (c == escape) {
+      if (i + 1 == pattern.size()) {
+        cerr << "LIKE pattern ends with its escape character" << endl;
+        exit(3);
+      }
+
+      c = pattern[++i];
+      wildcard = false;
+    }
+
+    Piece &piece = pieces.back();
+    piece.bytes.push_back(caseInsensitive && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    piece.wildcards.push_back(wildcard);
+    piece.hasWildcards |= wildcard;
+  }
+
+  // A trailing % leaves an empty piece behind
+  if (pieces.size() > 1 && pieces.back().bytes.empty()) pieces.pop_back();
+
+  const Piece &only = pieces.front();
+
+  if (only.bytes.empty()) shape = anchoredStart ? Shape::EXACT : Shape::ANY;
+  else if (pieces.size() == 1 && !only.hasWildcards) {
+    if (anchoredStart && anchoredEnd) shape = Shape::EXACT;
+    else if (anchoredStart) shape = Shape::PREFIX;
+    else if (anchoredEnd) shape = Shape::SUFFIX;
+    else shape = Shape::CONTAINS;
+  }
+}
+
+bool LikePattern::matches(string_view text) const {
+  if (shape == Shape::ANY) return true;
+
+  if (caseInsensitive) {
+    lowered.assign(text);
+    asciiLower(lowered.data(), lowered.size());
+    text = lowered;
+  }
+
+  const string &bytes = pieces.front().bytes;
+
+  switch (shape) {
+    case Shape::EXACT:
+      return text == bytes;
+
+    case Shape::PREFIX:
+      return text.size() >= bytes.size() && memcmp(text.data(), bytes.data(), bytes.size()) == 0;
+
+    case Shape::SUFFIX:
+      return text.size() >= bytes.size()
+          && memcmp(text.data() + text.size() - bytes.size(), bytes.data(), bytes.size()) == 0;
+
+    case Shape::CONTAINS:
+      return memmem(text.data(), text.size(), bytes.data(), bytes.size()) != nullptr;
+
+    default:
+      return matchesGeneral(text);
+  }
+}
+
+bool LikePattern::matchesGeneral(string_view text) const {
+  size_t first = 0;
+  size_t last = pieces.size();
+
+  size_t position = 0;
+  size_t end = text.size();
+
+  if (anchoredStart) {
+    const Piece &piece = pieces.front();
+
+    // No % at all: the piece has to be the whole string
+    if (pieces.size() == 1 && anchoredEnd && text.size() != piece.bytes.size()) return false;
+    if (!piece.matchesAt(text, 0)) return false;
+
+    position = piece.bytes.size();
+    ++first;
+  }
+
+  if (anchoredEnd && first < last) {
+    const Piece &piece = pieces.back();
+    if (piece.bytes.size() > end - position) return false;
+
+    end -= piece.bytes.size();
+    if (!piece.matchesAt(text, end)) return false;
+
+    --last;
+  }
+
+  for (size_t i = first; i < last; ++i) {
+    size_t found = pieces[i].find(text, position, end);
+    if (found == string_view::npos) return false;
+
+    position = found + pieces[i].bytes.size();
+  }
+
+  return true;
+}
+
+bool LikePattern::Piece::matchesAt(string_view text, size_t position) const {
+  if (bytes.size() > text.size() - position) return false;
+
+  if (!hasWildcards) return memcmp(text.data() + position, bytes.data(), bytes.size()) == 0;
+
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    if (!wildcards[i] && text[position + i] != bytes[i]) return false;
+  }
+
+  return true;
+}
+
+size_t LikePattern::Piece::find(string_view text, size_t from, size_t to) const {
+  if (bytes.size() > to - from) return string_view::npos;
+
+  if (!hasWildcards) {
+    const void *found = memmem(text.data() + from, to - from, bytes.data(), bytes.size());
+    return found ? static_cast<const char*>(found) - text.data() : string_view::npos;
+  }
+
+  for (size_t position = from; position + bytes.size() <= to; ++position) {
+    if (matchesAt(text, position)) return position;
+  }
+
+  return string_view::npos;
+}
+
+///////////////////////// LikePattern end //////////////////////////////////
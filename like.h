@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// SQL LIKE pattern, compiled once and then matched against any number of strings.
+// % matches any run of characters (even none), _ any single character, and escape
+// makes the character after it literal. Matching is done on bytes, so _ is one
+// byte of a UTF-8 multibyte character.
+// The common shapes get their own matcher: 'abc' is an equality, 'abc%' a prefix,
+// '%abc' a suffix and '%abc%' a substring search (memmem). Anything else is split on
+// its %s into pieces: the first and last are anchored to the ends of the string, the
+// ones in between are searched for left to right, and taking the leftmost place each
+// time never misses a match, so no backtracking is needed.
+// Case insensitive patterns (ILIKE) only fold ASCII letters, the text is lowered into
+// a scratch buffer first, so a pattern should not be shared between threads
+class LikePattern {
+  public:
+    LikePattern(const string &pattern, const bool caseInsensitive=false, const char escape='\\');
+
+    bool matches(string_view text) const;
+
+  private:
+    enum class Shape {ANY, EXACT, PREFIX, SUFFIX, CONTAINS, GENERAL};
+
+    // Literal bytes between two %s. wildcards marks the places holding an _
+    struct Piece {
+      string bytes;
+      vector<bool> wildcards;
+      bool hasWildcards = false;
+
+      bool matchesAt(string_view text, size_t position) const;
+
+      // Leftmost place in text[from, to) where the piece fits, npos if none
+      size_t find(string_view text, size_t from, size_t to) const;
+    };
+
+    Shape shape = Shape::GENERAL;
+    bool caseInsensitive;
+
+    vector<Piece> pieces;
+    bool anchoredStart = true;
+    bool anchoredEnd = true;
+
+    mutable string lowered;
+
+    bool matchesGeneral(string_view text) const;
+};
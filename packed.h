@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include "datatypes.h"
+
+using namespace std;
+
+// Describes how a value type is squeezed into a single primitive when stored in a
+// column. pack/unpack must round trip for every valid value
+template <typename Logical>
+struct Packing;
+
+// DATE: only the day number (Date::epoch) is kept, fields are derived on demand
+template <>
+struct Packing<Date> {
+  using Physical = int32_t;
+
+  Physical pack(const Date &value) const {
+    return value.epoch;
+  }
+
+  Date unpack(const Physical value) const {
+    return Date(static_cast<int>(value));
+  }
+};
+
+// TIME: microseconds since midnight. Precision is a column property, so it is
+// restored from the column (6 when the column accepts any precision)
+template <>
+struct Packing<Time> {
+  using Physical = int64_t;
+
+  int precision = 6;
+
+  Physical pack(const Time &value) const {
+    return timeToMicros(value);
+  }
+
+  Time unpack(const Physical value) const {
+    return microsToTime(value, precision);
+  }
+};
+
+// DATETIME: microseconds since 0001-01-01 00:00:00
+template <>
+struct Packing<Datetime> {
+  using Physical = int64_t;
+
+  int precision = 6;
+
+  Physical pack(const Datetime &value) const {
+    return datetimeToMicros(value);
+  }
+
+  Datetime unpack(const Physical value) const {
+    return microsToDatetime(value, precision);
+  }
+};
+
+// Buffer for value types that have a Packing. Cells live as a plain array of
+// Packing::Physical, which kernels can reach through raw(); operator[] rebuilds the
+// value type for everything else
+template <typename Logical>
+class PackedBuffer {
+  public:
+    using value_type = Logical;
+    using Physical = typename Packing<Logical>::Physical;
+
+    PackedBuffer(const Packing<Logical> Packer = {}) : packer(Packer) {}
+
+    int size() const {
+      return data.size();
+    }
+
+    void reserve(int capacity) {
+      data.reserve(capacity);
+    }
+
+    Logical operator[] (int index) const {
+      return packer.unpack(data[index]);
+    }
+
+    void push_back(const Logical &value) {
+      data.push_back(packer.pack(value));
+    }
+
+    // Appends a value that is already packed
+    void push_packed(const Physical value) {
+      data.push_back(value);
+    }
+
+    void set(int index, const Logical &value) {
+      data[index] = packer.pack(value);
+    }
+
+    void pop_back() {
+      data.pop_back();
+    }
+
+    void erase(int index) {
+      data.erase(data.begin() + index);
+    }
+
+    Physical pack(const Logical &value) const {
+      return packer.pack(value);
+    }
+
+    const vector<Physical>& raw() const {
+      return data;
+    }
+
+  private:
+    vector<Physical> data;
+    Packing<Logical> packer;
+};
+
+template <typename T>
+struct is_packed : std::false_type {};
+
+template <typename T>
+struct is_packed<PackedBuffer<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_packed_v = is_packed<T>::value;
@@ -0,0 +1,358 @@
+#include "reduce.h"
+#include <algorithm>
+#include <type_traits>
+
+// Same scheme as the predicate kernels: the AVX2 versions are always compiled, and
+// only picked at runtime when the CPU supports them
+#if defined(__GNUC__) && defined(__x86_64__)
+#define REDUCE_AVX2 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#ifdef __SIZEOF_INT128__
+using Int128 = __int128;
+#else
+using Int128 = long double;
+#endif
+
+// Accumulator that can hold any sum of Ts exactly (up to 2^31 values)
+template <typename T>
+using Wide = conditional_t<is_same_v<T, int64_t>, Int128, conditional_t<is_integral_v<T>, int64_t, double>>;
+
+// Values summed one after another before the pairwise float sum splits in halves
+constexpr int PAIRWISE_BLOCK = 128;
+
+// Calls dense(from, to) on every stretch of [first, last) where all values are valid,
+// and sparse(base, mask) on every word that is only partly valid, mask holding the
+// valid bits of values[base, base + 64) that fall in [first, last)
+template <typename Dense, typename Sparse>
+void forEachStretch(const int first, const int last, const uint64_t *validity, Dense &&dense, Sparse &&sparse) {
+  if (first >= last) return;
+
+  if (!validity) {
+    dense(first, last);
+    return;
+  }
+
+  int stretch = first;
+
+  for (int base = first & ~63; base < last; base += 64) {
+    uint64_t inRange = ~uint64_t(0);
+    if (base < first) inRange &= ~uint64_t(0) << (first - base);
+    if (last - base < 64) inRange &= (uint64_t(1) << (last - base)) - 1;
+
+    uint64_t mask = validity[base / 64] & inRange;
+    if (mask == inRange) continue;
+
+    if (stretch < std::max(base, first)) dense(stretch, std::max(base, first));
+    if (mask) sparse(base, mask);
+
+    stretch = std::min(base + 64, last);
+  }
+
+  if (stretch < last) dense(stretch, last);
+}
+
+template <typename T, typename Func>
+void forEachBit(const T *values, const int base, uint64_t mask, Func &&func) {
+  while (mask) {
+    func(values[base + __builtin_ctzll(mask)]);
+    mask &= mask - 1;
+  }
+}
+
+template <typename T>
+Wide<T> sumScalar(const T *values, const int count) {
+  Wide<T> total = 0;
+  for (int i = 0; i < count; ++i) total += values[i];
+  return total;
+}
+
+// Independent accumulators, so the additions don't wait on each other
+double blockSumScalar(const float *values, const int count) {
+  double lanes[4] = {0, 0, 0, 0};
+  int i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    for (int lane = 0; lane < 4; ++lane) lanes[lane] += values[i + lane];
+  }
+  for (; i < count; ++i) lanes[0] += values[i];
+
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Rounding error grows with log(count) instead of count
+template <typename Block>
+double pairwiseSum(const float *values, const int count, Block &&block) {
+  if (count <= PAIRWISE_BLOCK) return block(values, count);
+
+  int half = count / 2;
+  return pairwiseSum(values, half, block) + pairwiseSum(values + half, count - half, block);
+}
+
+// NaN fails both comparisons, so it is skipped
+template <typename T>
+void minMaxScalar(const T *values, const int count, T &min, T &max) {
+  for (int i = 0; i < count; ++i) {
+    min = values[i] < min ? values[i] : min;
+    max = values[i] > max ? values[i] : max;
+  }
+}
+
+#ifdef REDUCE_AVX2
+
+TARGET_AVX2 Int128 horizontalSum(const __m256i lanes) {
+  alignas(32) int64_t parts[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(parts), lanes);
+  return static_cast<Int128>(parts[0]) + parts[1] + parts[2] + parts[3];
+}
+
+// Adjacent pairs are added into int32 by madd, then widened to int64
+TARGET_AVX2 int64_t sumAvx2(const int16_t *values, const int count) {
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i total = _mm256_setzero_si256();
+  int i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256i pairs = _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), ones);
+    total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+    total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+  }
+
+  return static_cast<int64_t>(horizontalSum(total)) + sumScalar(values + i, count - i);
+}
+
+TARGET_AVX2 int64_t sumAvx2(const int32_t *values, const int count) {
+  __m256i low = _mm256_setzero_si256();
+  __m256i high = _mm256_setzero_si256();
+  int i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i))));
+    high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i + 4))));
+  }
+
+  return static_cast<int64_t>(horizontalSum(_mm256_add_epi64(low, high))) + sumScalar(values + i, count - i);
+}
+
+// Every value is split as unsigned low half + unsigned high half * 2^32 - 2^64 if it
+// is negative. Each part fits its 64 bit lane for 2^31 values, and the parts are
+// only put back together in 128 bits
+TARGET_AVX2 Int128 sumAvx2(const int64_t *values, const int count) {
+  const __m256i lowBits = _mm256_set1_epi64x(0xFFFFFFFF);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i low = zero;
+  __m256i high = zero;
+  __m256i negatives = zero;
+  int i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+    low = _mm256_add_epi64(low, _mm256_and_si256(value, lowBits));
+    high = _mm256_add_epi64(high, _mm256_srli_epi64(value, 32));
+    negatives = _mm256_add_epi64(negatives, _mm256_cmpgt_epi64(zero, value));
+  }
+
+  Int128 total = horizontalSum(low) + horizontalSum(high) * (Int128(1) << 32) +
+                 horizontalSum(negatives) * (Int128(1) << 32) * (Int128(1) << 32);
+
+  return total + sumScalar(values + i, count - i);
+}
+
+TARGET_AVX2 double blockSumAvx2(const float *values, const int count) {
+  __m256d low = _mm256_setzero_pd();
+  __m256d high = _mm256_setzero_pd();
+  int i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm_loadu_ps(values + i)));
+    high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm_loadu_ps(values + i + 4)));
+  }
+
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, _mm256_add_pd(low, high));
+
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + blockSumScalar(values + i, count - i);
+}
+
+double sumAvx2(const float *values, const int count) {
+  return pairwiseSum(values, count, blockSumAvx2);
+}
+
+// Per type AVX2 operations for min/max
+template <typename T>
+struct Avx2Lanes;
+
+template <>
+struct Avx2Lanes<int16_t> {
+  static constexpr int count = 16;
+
+  TARGET_AVX2 static __m256i broadcast(const int16_t value) {return _mm256_set1_epi16(value);}
+  TARGET_AVX2 static __m256i load(const int16_t *values) {return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));}
+  TARGET_AVX2 static void store(int16_t *out, const __m256i lanes) {_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), lanes);}
+  TARGET_AVX2 static __m256i min(const __m256i value, const __m256i acc) {return _mm256_min_epi16(value, acc);}
+  TARGET_AVX2 static __m256i max(const __m256i value, const __m256i acc) {return _mm256_max_epi16(value, acc);}
+};
+
+template <>
+struct Avx2Lanes<int32_t> {
+  static constexpr int count = 8;
+
+  TARGET_AVX2 static __m256i broadcast(const int32_t value) {return _mm256_set1_epi32(value);}
+  TARGET_AVX2 static __m256i load(const int32_t *values) {return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));}
+  TARGET_AVX2 static void store(int32_t *out, const __m256i lanes) {_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), lanes);}
+  TARGET_AVX2 static __m256i min(const __m256i value, const __m256i acc) {return _mm256_min_epi32(value, acc);}
+  TARGET_AVX2 static __m256i max(const __m256i value, const __m256i acc) {return _mm256_max_epi32(value, acc);}
+};
+
+// No 64 bit min/max in AVX2, so it is a compare and blend
+template <>
+struct Avx2Lanes<int64_t> {
+  static constexpr int count = 4;
+
+  TARGET_AVX2 static __m256i broadcast(const int64_t value) {return _mm256_set1_epi64x(value);}
+  TARGET_AVX2 static __m256i load(const int64_t *values) {return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));}
+  TARGET_AVX2 static void store(int64_t *out, const __m256i lanes) {_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), lanes);}
+
+  TARGET_AVX2 static __m256i min(const __m256i value, const __m256i acc) {
+    return _mm256_blendv_epi8(acc, value, _mm256_cmpgt_epi64(acc, value));
+  }
+
+  TARGET_AVX2 static __m256i max(const __m256i value, const __m256i acc) {
+    return _mm256_blendv_epi8(acc, value, _mm256_cmpgt_epi64(value, acc));
+  }
+};
+
+// min_ps/max_ps return their second operand when either is NaN, which keeps acc
+template <>
+struct Avx2Lanes<float> {
+  static constexpr int count = 8;
+
+  TARGET_AVX2 static __m256 broadcast(const float value) {return _mm256_set1_ps(value);}
+  TARGET_AVX2 static __m256 load(const float *values) {return _mm256_loadu_ps(values);}
+  TARGET_AVX2 static void store(float *out, const __m256 lanes) {_mm256_storeu_ps(out, lanes);}
+  TARGET_AVX2 static __m256 min(const __m256 value, const __m256 acc) {return _mm256_min_ps(value, acc);}
+  TARGET_AVX2 static __m256 max(const __m256 value, const __m256 acc) {return _mm256_max_ps(value, acc);}
+};
+
+template <typename T>
+TARGET_AVX2 void minMaxAvx2(const T *values, const int count, T &min, T &max) {
+  using Lanes = Avx2Lanes<T>;
+  auto lowest = Lanes::broadcast(min);
+  auto highest = Lanes::broadcast(max);
+  int i = 0;
+
+  for (; i + Lanes::count <= count; i += Lanes::count) {
+    auto value = Lanes::load(values + i);
+    lowest = Lanes::min(value, lowest);
+    highest = Lanes::max(value, highest);
+  }
+
+  T lows[Lanes::count];
+  T highs[Lanes::count];
+  Lanes::store(lows, lowest);
+  Lanes::store(highs, highest);
+
+  for (int lane = 0; lane < Lanes::count; ++lane) {
+    min = std::min(min, lows[lane]);
+    max = std::max(max, highs[lane]);
+  }
+
+  minMaxScalar(values + i, count - i, min, max);
+}
+
+bool hasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+#endif
+
+template <typename T>
+Wide<T> denseSum(const T *values, const int count) {
+#ifdef REDUCE_AVX2
+  if (hasAvx2()) return sumAvx2(values, count);
+#endif
+
+  if constexpr (is_floating_point_v<T>) return pairwiseSum(values, count, blockSumScalar);
+  else return sumScalar(values, count);
+}
+
+template <typename T>
+void denseMinMax(const T *values, const int count, T &min, T &max) {
+#ifdef REDUCE_AVX2
+  if (hasAvx2()) {
+    minMaxAvx2(values, count, min, max);
+    return;
+  }
+#endif
+
+  minMaxScalar(values, count, min, max);
+}
+
+} // namespace
+
+template <typename T>
+double sumValues(const T *values, int first, int last, const uint64_t *validity) {
+  Wide<T> total = 0;
+
+  forEachStretch(first, last, validity,
+    [&] (int from, int to) {total += denseSum(values + from, to - from);},
+    [&] (int base, uint64_t mask) {forEachBit(values, base, mask, [&] (T value) {total += value;});});
+
+  return static_cast<double>(total);
+}
+
+template <typename T>
+int countNaNs(const T *values, const int count) {
+  if constexpr (is_floating_point_v<T>) {
+    int nans = 0;
+    for (int i = 0; i < count; ++i) nans += values[i] != values[i];
+
+    return nans;
+  }
+
+  return 0;
+}
+
+template <typename T>
+int minMaxValues(const T *values, int first, int last, const uint64_t *validity, T &min, T &max) {
+  int folded = 0;
+
+  forEachStretch(first, last, validity,
+    [&] (int from, int to) {
+      denseMinMax(values + from, to - from, min, max);
+      folded += to - from - countNaNs(values + from, to - from);
+    },
+    [&] (int base, uint64_t mask) {
+      forEachBit(values, base, mask, [&] (T value) {
+        minMaxScalar(&value, 1, min, max);
+        folded += 1 - countNaNs(&value, 1);
+      });
+    });
+
+  return folded;
+}
+
+int countValid(int first, int last, const uint64_t *validity) {
+  int valid = 0;
+
+  forEachStretch(first, last, validity,
+    [&] (int from, int to) {valid += to - from;},
+    [&] (int, uint64_t mask) {valid += __builtin_popcountll(mask);});
+
+  return valid;
+}
+
+template double sumValues<int16_t>(const int16_t *, int, int, const uint64_t *);
+template double sumValues<int32_t>(const int32_t *, int, int, const uint64_t *);
+template double sumValues<int64_t>(const int64_t *, int, int, const uint64_t *);
+template double sumValues<float>(const float *, int, int, const uint64_t *);
+
+template int minMaxValues<int16_t>(const int16_t *, int, int, const uint64_t *, int16_t &, int16_t &);
+template int minMaxValues<int32_t>(const int32_t *, int, int, const uint64_t *, int32_t &, int32_t &);
+template int minMaxValues<int64_t>(const int64_t *, int, int, const uint64_t *, int64_t &, int64_t &);
+template int minMaxValues<float>(const float *, int, int, const uint64_t *, float &, float &);
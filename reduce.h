@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+using namespace std;
+
+// Reduction kernels over values[first, last). validity, when not null, holds one bit
+// per value counting from values[0] (a segment's validity words), and only values
+// whose bit is set are reduced. Fully valid words go through the dense kernels, on
+// x86 CPUs with AVX2 those run 4 to 16 values at a time.
+
+// Sums are exact until the final conversion to double: 16 and 32 bit integers are
+// widened to 64 bits, 64 bit integers to 128 bits. Floats are summed pairwise in
+// double precision
+template <typename T>
+double sumValues(const T *values, int first, int last, const uint64_t *validity);
+
+// Folds the values into min and max, which keep their value when there are none.
+// NaNs are skipped. Returns how many values were folded, so NaNs aren't counted
+template <typename T>
+int minMaxValues(const T *values, int first, int last, const uint64_t *validity, T &min, T &max);
+
+// How many values in [first, last) are valid
+int countValid(int first, int last, const uint64_t *validity);
+
+extern template double sumValues<int16_t>(const int16_t *, int, int, const uint64_t *);
+extern template double sumValues<int32_t>(const int32_t *, int, int, const uint64_t *);
+extern template double sumValues<int64_t>(const int64_t *, int, int, const uint64_t *);
+extern template double sumValues<float>(const float *, int, int, const uint64_t *);
+
+extern template int minMaxValues<int16_t>(const int16_t *, int, int, const uint64_t *, int16_t &, int16_t &);
+extern template int minMaxValues<int32_t>(const int32_t *, int, int, const uint64_t *, int32_t &, int32_t &);
+extern template int minMaxValues<int64_t>(const int64_t *, int, int, const uint64_t *, int64_t &, int64_t &);
+extern template int minMaxValues<float>(const float *, int, int, const uint64_t *, float &, float &);
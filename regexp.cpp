@@ -0,0 +1,613 @@
+#include "regexp.h"
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+////////////////////////// RegexCompiler ///////////////////////////////////
+
+// Parses the pattern into a tree, which is then laid out as Thompson NFA fragments.
+// Reversed, the NFA matches the pattern read back to front
+class RegexCompiler {
+  public:
+    RegexCompiler(Regex &Target, string_view Pattern, const bool CaseInsensitive, const bool Reversed=false) :
+      target(Target), pattern(Pattern), caseInsensitive(CaseInsensitive), reversed(Reversed) {}
+
+    void compile() {
+      Tree tree = parseAlternation();
+      if (position != pattern.size()) fail("unmatched )");
+
+      Fragment whole = build(tree);
+      int match = target.addNode(Regex::NfaNode::Kind::MATCH);
+
+      patch(whole, match);
+      target.startNode = whole.start;
+    }
+
+  private:
+    // Repetitions are laid out as copies of what they repeat
+    static constexpr int MAX_REPEAT = 1000;
+    static constexpr int MAX_NODES = 100000;
+
+    struct Tree {
+      enum class Kind {BYTES, CONCAT, ALTERNATE, REPEAT, BEGIN, END};
+
+      Tree(const Kind Kind) : kind(Kind) {}
+
+      Kind kind;
+      bitset<256> bytes;
+      vector<Tree> children;
+
+      // -1 for no upper bound
+      int min = 0;
+      int max = 0;
+    };
+
+    // Entry node, and the node slots (node, is alternative) still to point somewhere
+    struct Fragment {
+      int start;
+      vector<pair<int, bool>> exits;
+    };
+
+    Regex &target;
+    string_view pattern;
+    bool caseInsensitive;
+    bool reversed;
+    size_t position = 0;
+
+    [[noreturn]] void fail(const string &reason) const {
+      cerr << "Invalid regular expression " << pattern << ": " << reason << endl;
+      exit(3);
+    }
+
+    bool atEnd() const {
+      return position == pattern.size();
+    }
+
+    Tree bytesTree(const bitset<256> &bytes) const {
+      Tree tree{Tree::Kind::BYTES};
+      tree.bytes = bytes;
+      return tree;
+    }
+
+    void addByte(bitset<256> &bytes, const uint8_t byte) const {
+      bytes.set(byte);
+      if (!caseInsensitive) return;
+
+      if (byte >= 'a' && byte <= 'z') bytes.set(byte - 'a' + 'A');
+      if (byte >= 'A' && byte <= 'Z') bytes.set(byte - 'A' + 'a');
+    }
+
+    // \d \w \s and their negations, false if letter is none of them
+    bool addShorthand(bitset<256> &bytes, const char letter) const {
+      bitset<256> shorthand;
+
+      for (int byte = 0; byte < 256; ++byte) {
+        switch (letter | 0x20) {
+          case 'd': shorthand[byte] = byte >= '0' && byte <= '9'; break;
+          case 'w': shorthand[byte] = isalnum(byte) || byte == '_'; break;
+          case 's': shorthand[byte] = byte == ' ' || (byte >= '\t' && byte <= '\r'); break;
+          default: return false;
+        }
+      }
+
+      // Upper case letters negate
+      if (letter >= 'A' && letter <= 'Z') shorthand.flip();
+      bytes |= shorthand;
+      return true;
+    }
+
+    // The byte an escape stands for, after the backslash
+    uint8_t escapedByte(const char c) const {
+      switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case '0': return '\0';
+      }
+
+      if (isalnum(static_cast<uint8_t>(c))) fail(string("unsupported escape \\") + c);
+      return c;
+    }
+
+    Tree parseAlternation() {
+      Tree first = parseConcat();
+      if (atEnd() || pattern[position] != '|') return first;
+
+      Tree alternation{Tree::Kind::ALTERNATE};
+      alternation.children.push_back(std::move(first));
+
+      while (!atEnd() && pattern[position] == '|') {
+        ++position;
+        alternation.children.push_back(parseConcat());
+      }
+
+      return alternation;
+    }
+
+    Tree parseConcat() {
+      Tree concat{Tree::Kind::CONCAT};
+
+      while (!atEnd() && pattern[position] != '|' && pattern[position] != ')') {
+        concat.children.push_back(parseRepeat());
+      }
+
+      return concat;
+    }
+
+    Tree parseRepeat() {
+      Tree atom = parseAtom();
+
+      while (!atEnd()) {
+        int min, max;
+        char c = pattern[position];
+
+        if (c == '*') {min = 0; max = -1;}
+        else if (c == '+') {min = 1; max = -1;}
+        else if (c == '?') {min = 0; max = 1;}
+        else if (c == '{') parseBounds(min, max);
+        else break;
+
+        if (c != '{') ++position;
+
+        if (!atEnd() && pattern[position] == '?') fail("lazy quantifiers are not supported");
+        if (atom.kind == Tree::Kind::BEGIN || atom.kind == Tree::Kind::END) fail("anchors can't be repeated");
+
+        Tree repeat{Tree::Kind::REPEAT};
+        repeat.min = min;
+        repeat.max = max;
+        repeat.children.push_back(std::move(atom));
+        atom = std::move(repeat);
+      }
+
+      return atom;
+    }
+
+    int parseNumber() {
+      size_t first = position;
+      int number = 0;
+
+      while (!atEnd() && isdigit(static_cast<uint8_t>(pattern[position]))) {
+        number = number * 10 + (pattern[position++] - '0');
+        if (number > MAX_REPEAT) fail("repetition count over " + to_string(MAX_REPEAT));
+      }
+
+      if (position == first) fail("bad repetition bounds");
+      return number;
+    }
+
+    void parseBounds(int &min, int &max) {
+      ++position;
+      min = max = parseNumber();
+
+      if (!atEnd() && pattern[position] == ',') {
+        ++position;
+        max = !atEnd() && pattern[position] == '}' ? -1 : parseNumber();
+      }
+
+      if (atEnd() || pattern[position] != '}') fail("bad repetition bounds");
+      if (max != -1 && max < min) fail("bad repetition bounds");
+      ++position;
+    }
+
+    Tree parseAtom() {
+      char c = pattern[position++];
+      bitset<256> bytes;
+
+      switch (c) {
+        case '(': {
+          if (pattern.substr(position, 2) == "?:") position += 2;
+
+          Tree inner = parseAlternation();
+          if (atEnd() || pattern[position] != ')') fail("missing )");
+          ++position;
+          return inner;
+        }
+
+        case '[':
+          return parseClass();
+
+        case '.':
+          bytes.set();
+          bytes.reset('\n');
+          return bytesTree(bytes);
+
+        case '^':
+          return Tree{Tree::Kind::BEGIN};
+
+        case '$':
+          return Tree{Tree::Kind::END};
+
+        case '*': case '+': case '?': case '{':
+          fail("nothing to repeat");
+
+        case '\\':
+          if (atEnd()) fail("trailing \\");
+
+          c = pattern[position++];
+          if (!addShorthand(bytes, c)) addByte(bytes, escapedByte(c));
+          return bytesTree(bytes);
+      }
+
+      addByte(bytes, c);
+      return bytesTree(bytes);
+    }
+
+    Tree parseClass() {
+      bitset<256> bytes;
+
+      bool negated = !atEnd() && pattern[position] == '^';
+      if (negated) ++position;
+
+      // A ] right at the start is taken literally
+      bool first = true;
+
+      while (true) {
+        if (atEnd()) fail("missing ]");
+
+        char c = pattern[position++];
+        if (c == ']' && !first) break;
+        first = false;
+
+        if (c == '\\') {
+          if (atEnd()) fail("missing ]");
+
+          c = pattern[position++];
+          if (addShorthand(bytes, c)) continue;
+          c = escapedByte(c);
+        }
+
+        // Range, unless the - is the last thing in the class
+        if (position + 1 < pattern.size() && pattern[position] == '-' && pattern[position + 1] != ']') {
+          ++position;
+
+          char last = pattern[position++];
+          if (last == '\\') {
+            if (atEnd()) fail("missing ]");
+            last = escapedByte(pattern[position++]);
+          }
+
+          if (static_cast<uint8_t>(last) < static_cast<uint8_t>(c)) fail("reversed class range");
+
+          for (int byte = static_cast<uint8_t>(c); byte <= static_cast<uint8_t>(last); ++byte) {
+            addByte(bytes, byte);
+          }
+          continue;
+        }
+
+        addByte(bytes, c);
+      }
+
+      if (negated) bytes.flip();
+      return bytesTree(bytes);
+    }
+
+    int addNode(const Regex::NfaNode::Kind kind) {
+      if (target.nfa.size() >= MAX_NODES) fail("pattern too large");
+      return target.addNode(kind);
+    }
+
+    void patch(const Fragment &fragment, const int node) {
+      for (auto [exit, alternative] : fragment.exits) {
+        if (alternative) target.nfa[exit].alternative = node;
+        else target.nfa[exit].next = node;
+      }
+    }
+
+    // Fragment going straight through, what's empty is laid out as
+    Fragment empty() {
+      int node = addNode(Regex::NfaNode::Kind::EMPTY);
+      return {node, {{node, false}}};
+    }
+
+    // Fragment for one, followed by the one for two
+    Fragment chain(Fragment one, const Fragment &two) {
+      patch(one, two.start);
+      return {one.start, two.exits};
+    }
+
+    // Fragment that either goes through inner, or skips it. With loop, inner goes
+    // back to the choice when done
+    Fragment optional(const Fragment &inner, const bool loop) {
+      int split = addNode(Regex::NfaNode::Kind::SPLIT);
+      target.nfa[split].next = inner.start;
+
+      Fragment fragment{split, {{split, true}}};
+
+      if (loop) patch(inner, split);
+      else fragment.exits.insert(fragment.exits.end(), inner.exits.begin(), inner.exits.end());
+
+      return fragment;
+    }
+
+    Fragment build(const Tree &tree) {
+      switch (tree.kind) {
+        case Tree::Kind::BYTES: {
+          int node = addNode(Regex::NfaNode::Kind::BYTES);
+          target.nfa[node].bytes = tree.bytes;
+          return {node, {{node, false}}};
+        }
+
+        // Read back to front, the start of the text is its end
+        case Tree::Kind::BEGIN:
+        case Tree::Kind::END: {
+          bool begin = (tree.kind == Tree::Kind::BEGIN) != reversed;
+          int node = addNode(begin ? Regex::NfaNode::Kind::BEGIN : Regex::NfaNode::Kind::END);
+          return {node, {{node, false}}};
+        }
+
+        case Tree::Kind::CONCAT: {
+          if (tree.children.empty()) return empty();
+
+          vector<const Tree*> children;
+          for (const Tree &child : tree.children) children.push_back(&child);
+          if (reversed) std::reverse(children.begin(), children.end());
+
+          Fragment fragment = build(*children.front());
+          for (size_t i = 1; i < children.size(); ++i) {
+            fragment = chain(std::move(fragment), build(*children[i]));
+          }
+
+          return fragment;
+        }
+
+        case Tree::Kind::ALTERNATE: {
+          // Chain of splits, each one taking an alternative or moving on to the next split
+          Fragment fragment = build(tree.children.back());
+
+          for (int i = static_cast<int>(tree.children.size()) - 2; i >= 0; --i) {
+            Fragment alternative = build(tree.children[i]);
+
+            int split = addNode(Regex::NfaNode::Kind::SPLIT);
+            target.nfa[split].next = alternative.start;
+            target.nfa[split].alternative = fragment.start;
+
+            fragment.start = split;
+            fragment.exits.insert(fragment.exits.end(), alternative.exits.begin(), alternative.exits.end());
+          }
+
+          return fragment;
+        }
+
+        case Tree::Kind::REPEAT: {
+          const Tree &inner = tree.children.front();
+
+          // x{2,4} is laid out as xx(x)?(x)?, and x{2,} as xx(x)*
+          Fragment fragment = empty();
+          for (int i = 0; i < tree.min; ++i) fragment = chain(std::move(fragment), build(inner));
+
+          if (tree.max == -1) return chain(std::move(fragment), optional(build(inner), true));
+
+          for (int i = tree.min; i < tree.max; ++i) {
+            fragment = chain(std::move(fragment), optional(build(inner), false));
+          }
+
+          return fragment;
+        }
+      }
+
+      return empty();
+    }
+};
+
+//////////////////////// RegexCompiler end /////////////////////////////////
+
+
+
+/////////////////////////////// Regex //////////////////////////////////////
+
+Regex::Regex(const string &Pattern, const bool CaseInsensitive) : Regex(Pattern, CaseInsensitive, false) {}
+
+Regex::Regex(const string &Pattern, const bool CaseInsensitive, const bool Reversed) :
+  pattern(Pattern), caseInsensitive(CaseInsensitive) {
+  RegexCompiler(*this, pattern, caseInsensitive, Reversed).compile();
+  starts.fill(UNKNOWN);
+}
+
+shared_ptr<Regex> Regex::compiled(const string &pattern, const bool caseInsensitive) {
+  static unordered_map<string, shared_ptr<Regex>> cache;
+
+  string key = (caseInsensitive ? "i" : "c") + pattern;
+
+  auto found = cache.find(key);
+  if (found != cache.end()) return found->second;
+
+  // Plenty for the patterns of a workload, patterns generated per row just get
+  // compiled again after a flush. Callers still holding one keep it alive
+  if (cache.size() >= MAX_CACHED_PATTERNS) cache.clear();
+
+  shared_ptr<Regex> regex = make_shared<Regex>(pattern, caseInsensitive);
+  cache.emplace(std::move(key), regex);
+
+  return regex;
+}
+
+int Regex::addNode(const NfaNode::Kind kind, const int next, const int alternative) {
+  nfa.push_back(NfaNode{kind, {}, next, alternative});
+  return nfa.size() - 1;
+}
+
+// Adds node and what it reaches through epsilon moves. Only nodes that matter to
+// the next steps are kept: BYTES, MATCH, and END for the end of the text
+void Regex::closure(int node, const bool atStart, const bool atEnd,
+                    vector<int> &nodes, vector<bool> &seen) const {
+  while (node != -1 && !seen[node]) {
+    seen[node] = true;
+    const NfaNode &current = nfa[node];
+
+    switch (current.kind) {
+      case NfaNode::Kind::BYTES:
+      case NfaNode::Kind::MATCH:
+        nodes.push_back(node);
+        return;
+
+      case NfaNode::Kind::SPLIT:
+        closure(current.alternative, atStart, atEnd, nodes, seen);
+        break;
+
+      case NfaNode::Kind::BEGIN:
+        if (!atStart) return;
+        break;
+
+      case NfaNode::Kind::END:
+        if (!atEnd) {
+          nodes.push_back(node);
+          return;
+        }
+        break;
+
+      case NfaNode::Kind::EMPTY:
+        break;
+    }
+
+    node = current.next;
+  }
+}
+
+int Regex::intern(vector<int> nodes, const bool searching) const {
+  sort(nodes.begin(), nodes.end());
+  if (nodes.empty() && !searching) return DEAD;
+
+  auto key = make_pair(searching, std::move(nodes));
+
+  auto found = stateIds.find(key);
+  if (found != stateIds.end()) return found->second;
+
+  DfaState state;
+  state.nodes = key.second;
+  state.searching = searching;
+  state.transitions.fill(UNKNOWN);
+
+  state.accepting = false;
+  vector<bool> seen(nfa.size(), false);
+  vector<int> atEnd;
+
+  for (int node : state.nodes) {
+    if (nfa[node].kind == NfaNode::Kind::MATCH) state.accepting = true;
+    if (nfa[node].kind == NfaNode::Kind::END) closure(node, false, true, atEnd, seen);
+  }
+
+  state.acceptingAtEnd = state.accepting || any_of(atEnd.begin(), atEnd.end(), [this] (int node) {
+    return nfa[node].kind == NfaNode::Kind::MATCH;
+  });
+
+  states.push_back(std::move(state));
+  stateIds.emplace(std::move(key), states.size() - 1);
+
+  return states.size() - 1;
+}
+
+int Regex::startState(const bool atStart, const bool searching) const {
+  int &start = starts[atStart * 2 + searching];
+  if (start != UNKNOWN) return start;
+
+  vector<int> nodes;
+  vector<bool> seen(nfa.size(), false);
+  closure(startNode, atStart, false, nodes, seen);
+
+  start = intern(std::move(nodes), searching);
+  return start;
+}
+
+int Regex::step(const int state, const uint8_t byte) const {
+  int known = states[state].transitions[byte];
+  if (known != UNKNOWN) return known;
+
+  const bool searching = states[state].searching;
+
+  vector<int> nodes;
+  vector<bool> seen(nfa.size(), false);
+
+  for (int node : states[state].nodes) {
+    if (nfa[node].kind == NfaNode::Kind::BYTES && nfa[node].bytes[byte]) {
+      closure(nfa[node].next, false, false, nodes, seen);
+    }
+  }
+
+  if (searching) closure(startNode, false, false, nodes, seen);
+
+  // Start over rather than growing without bounds. The caller only goes on from
+  // the state handed back, so dropping the others is safe
+  if (states.size() >= MAX_DFA_STATES) {
+    states.clear();
+    stateIds.clear();
+    starts.fill(UNKNOWN);
+    return intern(std::move(nodes), searching);
+  }
+
+  int next = intern(std::move(nodes), searching);
+  states[state].transitions[byte] = next;
+
+  return next;
+}
+
+bool Regex::search(string_view text) const {
+  int state = startState(true, true);
+
+  for (char c : text) {
+    if (states[state].accepting) return true;
+    state = step(state, c);
+  }
+
+  return states[state].acceptingAtEnd;
+}
+
+const Regex &Regex::backward() const {
+  if (!reversed) reversed.reset(new Regex(pattern, caseInsensitive, true));
+  return *reversed;
+}
+
+// The reverse automaton, searching, reads the text from its end down to from. It
+// accepts after reading text[i...] back to front iff a match starts at i
+size_t Regex::scanStarts(string_view text, const size_t from, vector<bool> *matchStarts) const {
+  const Regex &reverse = backward();
+  size_t leftmost = string_view::npos;
+
+  int state = reverse.startState(true, true);
+  for (size_t i = text.size(); ; --i) {
+    const DfaState &current = reverse.states[state];
+
+    if (i == 0 ? current.acceptingAtEnd : current.accepting) {
+      leftmost = i;
+      if (matchStarts) (*matchStarts)[i] = true;
+    }
+
+    if (i == from) return leftmost;
+    state = reverse.step(state, text[i - 1]);
+  }
+}
+
+void Regex::matchStarts(string_view text, vector<bool> &starts) const {
+  starts.assign(text.size() + 1, false);
+  scanStarts(text, 0, &starts);
+}
+
+size_t Regex::longestMatch(string_view text, const size_t start) const {
+  size_t length = string_view::npos;
+  int state = startState(start == 0, false);
+
+  for (size_t i = start; state != DEAD; ++i) {
+    if (i == text.size() ? states[state].acceptingAtEnd : states[state].accepting) length = i - start;
+
+    if (i == text.size()) break;
+    state = step(state, text[i]);
+  }
+
+  return length;
+}
+
+// One pass back to front finds the leftmost start, one from there the longest match
+bool Regex::find(string_view text, size_t from, size_t &start, size_t &length) const {
+  if (from > text.size()) return false;
+
+  size_t leftmost = scanStarts(text, from, nullptr);
+  if (leftmost == string_view::npos) return false;
+
+  start = leftmost;
+  length = longestMatch(text, start);
+
+  return true;
+}
+
+///////////////////////////// Regex end ////////////////////////////////////
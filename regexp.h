@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <bitset>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Regular expression compiled to an automaton that matches in one table lookup per
+// byte, with no backtracking, so the time taken is linear in the text whatever the
+// pattern. Finding where a match starts takes a second automaton, for the pattern
+// read back to front. The pattern becomes an NFA, and the DFA states are built from
+// it lazily, the first time a (state, byte) transition is taken, then kept for the
+// next rows and the next calls. Compile through Regex::compiled, which keeps every
+// pattern's automaton around (and so its DFA states too).
+// Supported: literals, ., [classes] with ranges and ^, \d \w \s and their negations,
+// (groups) and (?:groups), |, * + ? {m} {m,} {m,n}, and ^ $ anchoring to the ends of
+// the text. Groups don't capture, and matches are leftmost, then longest (POSIX),
+// so quantifiers can't be lazy. Matching is done on bytes, . is any byte but '\n'.
+// Invalid patterns exit with code 3. Not thread safe: matching adds DFA states
+class Regex {
+  public:
+    Regex(const string &pattern, const bool caseInsensitive=false);
+
+    // Automaton for pattern, compiled on its first use
+    static shared_ptr<Regex> compiled(const string &pattern, const bool caseInsensitive=false);
+
+    // True if the pattern matches anywhere in text
+    bool search(string_view text) const;
+
+    // Leftmost, then longest, match in text starting at from or later
+    bool find(string_view text, size_t from, size_t &start, size_t &length) const;
+
+    // starts[i] is set if a match starts at text[i], i up to text.size(). Lets a
+    // caller step through all the matches of a text with a single backward pass
+    void matchStarts(string_view text, vector<bool> &starts) const;
+
+    // Length of the longest match starting at text[start], npos if there is none
+    size_t longestMatch(string_view text, const size_t start) const;
+
+  private:
+    Regex(const string &Pattern, const bool CaseInsensitive, const bool Reversed);
+
+    static constexpr int MAX_CACHED_PATTERNS = 256;
+
+    // Beyond this the DFA states are dropped and built again as needed, patterns
+    // whose DFA would blow up exponentially just get slower
+    static constexpr int MAX_DFA_STATES = 4096;
+
+    static constexpr int DEAD = -1;
+    static constexpr int UNKNOWN = -2;
+
+    // Thompson NFA. BYTES nodes consume a byte in their set, the others are
+    // epsilon moves: SPLIT goes to both next and alternative, BEGIN and END only
+    // when at the start or end of the text
+    struct NfaNode {
+      enum class Kind {BYTES, SPLIT, EMPTY, BEGIN, END, MATCH};
+
+      Kind kind;
+      bitset<256> bytes;
+      int next = -1;
+      int alternative = -1;
+    };
+
+    struct DfaState {
+      vector<int> nodes;
+
+      // Search states restart the pattern at every byte
+      bool searching;
+
+      // A match ends here; or ends here if this is the end of the text
+      bool accepting;
+      bool acceptingAtEnd;
+
+      array<int, 256> transitions;
+    };
+
+    string pattern;
+    bool caseInsensitive;
+
+    vector<NfaNode> nfa;
+    int startNode;
+
+    // Automaton for the pattern read back to front, built on the first find
+    mutable unique_ptr<Regex> reversed;
+
+    mutable vector<DfaState> states;
+    mutable map<pair<bool, vector<int>>, int> stateIds;
+
+    // Start states by (at the start of the text, searching), UNKNOWN until built
+    mutable array<int, 4> starts;
+
+    int addNode(const NfaNode::Kind kind, const int next=-1, const int alternative=-1);
+
+    void closure(int node, const bool atStart, const bool atEnd, vector<int> &nodes, vector<bool> &seen) const;
+
+    int startState(const bool atStart, const bool searching) const;
+    int intern(vector<int> nodes, const bool searching) const;
+    int step(const int state, const uint8_t byte) const;
+
+    const Regex &backward() const;
+
+    // Leftmost match start at from or later, npos if none. Marks every start in
+    // matchStarts when given one
+    size_t scanStarts(string_view text, const size_t from, vector<bool> *matchStarts) const;
+
+    friend class RegexCompiler;
+};
@@ -0,0 +1,138 @@
+#include "selection.h"
+
+////////////////////////////// Selection //////////////////////////////////
+
+Selection::Selection() : rows(Range{0, 0}) {}
+
+Selection::Selection(const vector<int> &Indices) : rows(Indices), selected(Indices.size()) {}
+
+Selection::Selection(vector<int> &&Indices) : selected(Indices.size()) {
+  rows = std::move(Indices);
+}
+
+Selection::Selection(initializer_list<int> Indices) : rows(vector<int>(Indices)), 
+  selected(Indices.size()) {}
+
+Selection::Selection(Bitmap Bits) : selected(Bits.count()) {
+  rows = std::move(Bits);
+}
+
+Selection Selection::all(int rows) {
+  return range(0, rows);
+}
+
+Selection Selection::range(int begin, int end) {
+  Selection selection;
+  selection.rows = Range{begin, std::max(begin, end)};
+  selection.selected = std::max(begin, end) - begin;
+
+  return selection;
+}
+
+// A list takes 32 bits per selected row against 1 bit per row for the bitmap
+Selection Selection::adaptive(Bitmap bits) {
+  int selected = bits.count();
+
+  if (selected == bits.size()) return all(bits.size());
+
+  if (selected < bits.size() / 32) {
+    vector<int> indices;
+    indices.reserve(selected);
+
+    for (int i = bits.nextSet(0); i < bits.size(); i = bits.nextSet(i + 1)) {
+      indices.push_back(i);
+    }
+
+    return Selection(std::move(indices));
+  }
+
+  return Selection(std::move(bits));
+}
+
+Selection::Kind Selection::kind() const {
+  return static_cast<Kind>(rows.index());
+}
+
+int Selection::size() const {
+  return selected;
+}
+
+bool Selection::empty() const {
+  return selected == 0;
+}
+
+int Selection::extent() const {
+  switch (kind()) {
+    case Kind::RANGE: return get<Range>(rows).end;
+    case Kind::BITMAP: return get<Bitmap>(rows).size();
+    default: {
+      const vector<int> &indices = get<vector<int>>(rows);
+      return indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
+    }
+  }
+}
+
+vector<int> Selection::toVector() const {
+  if (kind() == Kind::LIST) return get<vector<int>>(rows);
+
+  vector<int> indices;
+  indices.reserve(selected);
+  forEach([&indices] (int i) {indices.push_back(i);});
+
+  return indices;
+}
+
+Bitmap Selection::toBitmap(int size) const {
+  if (kind() == Kind::BITMAP && get<Bitmap>(rows).size() == size) return get<Bitmap>(rows);
+
+  Bitmap bits(size);
+  forEach([&bits, size] (int i) {
+    if (i < size) bits.set(i, true);
+  });
+
+  return bits;
+}
+
+Selection Selection::operator&(const Selection &rhs) const {
+  if (kind() == Kind::RANGE && rhs.kind() == Kind::RANGE) {
+    const Range &lhsRange = get<Range>(rows);
+    const Range &rhsRange = get<Range>(rhs.rows);
+
+    return range(std::max(lhsRange.begin, rhsRange.begin), std::min(lhsRange.end, rhsRange.end));
+  }
+
+  int size = std::max(extent(), rhs.extent());
+
+  Bitmap bits = toBitmap(size);
+  bits &= rhs.toBitmap(size);
+
+  return adaptive(std::move(bits));
+}
+
+Selection Selection::operator|(const Selection &rhs) const {
+  int size = std::max(extent(), rhs.extent());
+
+  Bitmap bits = toBitmap(size);
+  bits |= rhs.toBitmap(size);
+
+  return adaptive(std::move(bits));
+}
+
+bool operator==(const Selection &lhs, const Selection &rhs) {
+  return lhs.size() == rhs.size() && lhs.toVector() == rhs.toVector();
+}
+
+ostream& operator<<(ostream& os, const Selection &self){
+  os << "{";
+
+  bool first = true;
+  self.forEach([&os, &first] (int i) {
+    os << (first ? "" : ", ") << i;
+    first = false;
+  });
+
+  os << "}";
+  return os;
+}
+
+//////////////////////////// Selection end /////////////////////////////////
@@ -0,0 +1,153 @@
+#pragma once
+#include <vector>
+#include <variant>
+#include <span>
+#include <iostream>
+#include <initializer_list>
+#include <algorithm>
+#include "bitmap.h"
+
+using namespace std;
+
+// Iterable over the consecutive indices [first, last)
+class IndexRange {
+  public:
+    struct iterator {
+      int index;
+
+      int operator*() const {return index;}
+      iterator& operator++() {++index; return *this;}
+      bool operator!=(const iterator &rhs) const {return index != rhs.index;}
+    };
+
+    IndexRange(int First, int Last) : first(First), last(Last) {}
+
+    iterator begin() const {return {first};}
+    iterator end() const {return {last};}
+    int size() const {return last - first;}
+    int getFirst() const {return first;}
+    int getLast() const {return last;}
+
+  private:
+    int first;
+    int last;
+};
+
+// Runs that are a dense range, which kernels can take as a slice of the buffer
+template <typename Run>
+constexpr bool is_index_range_v = is_same_v<decay_t<Run>, IndexRange>;
+
+// Iterable over the set bits of a Bitmap in [first, last)
+class BitRange {
+  public:
+    struct iterator {
+      const Bitmap *bits;
+      int index;
+      int last;
+
+      int operator*() const {return index;}
+      iterator& operator++() {index = std::min(bits->nextSet(index + 1), last); return *this;}
+      bool operator!=(const iterator &rhs) const {return index != rhs.index;}
+    };
+
+    BitRange(const Bitmap &Bits, int First, int Last) : bits(&Bits), first(First), last(Last) {}
+
+    iterator begin() const {return {bits, std::min(bits->nextSet(first), last), last};}
+    iterator end() const {return {bits, last, last};}
+
+  private:
+    const Bitmap *bits;
+    int first;
+    int last;
+};
+
+// The rows a Column function works on. Depending on what it comes from it is
+// either a dense range (full scans, which then cost nothing to express), an
+// explicit list of indices (kept in the order given), or a bitmap over the rows
+// (predicate results, so chaining predicates is a word-wise and/or).
+// Implicitly built from a vector<int> or {...}, so index lists still work as before
+class Selection {
+  public:
+    enum class Kind {RANGE, LIST, BITMAP};
+
+    Selection();
+    Selection(const vector<int> &Indices);
+    Selection(vector<int> &&Indices);
+    Selection(initializer_list<int> Indices);
+    Selection(Bitmap Bits);
+
+    // [0, rows) and [begin, end)
+    static Selection all(int rows);
+    static Selection range(int begin, int end);
+
+    // Picks the cheapest representation for the set bits of bits: a range when all
+    // are set, a list when few are, and the bitmap itself otherwise
+    static Selection adaptive(Bitmap bits);
+
+    Kind kind() const;
+
+    // Number of selected rows, O(1)
+    int size() const;
+    bool empty() const;
+
+    // One past the largest index that can be selected
+    int extent() const;
+
+    // Calls func(i) on every selected index, in ascending order except for lists
+    template <typename Func>
+    void forEach(Func &&func) const {
+      visit([&func] (const auto &run) {
+        for (int i : run) func(i);
+      });
+    }
+
+    // Hands func the underlying iterable (IndexRange, span<const int> or BitRange)
+    // restricted to [first, last), so callers can loop without a branch per row.
+    // Lists are not restricted, they are handed whole
+    template <typename Func>
+    void visit(Func &&func, int first=0, int last=-1) const {
+      switch (kind()) {
+        case Kind::RANGE: {
+          const auto &[begin, end] = get<Range>(rows);
+          int from = std::max(begin, first);
+          int to = last == -1 ? end : std::min(end, last);
+
+          func(IndexRange(from, std::max(to, from)));
+          return;
+        }
+        case Kind::LIST: {
+          const vector<int> &indices = get<vector<int>>(rows);
+          func(span<const int>(indices.data(), indices.size()));
+          return;
+        }
+        default: {
+          const Bitmap &bits = get<Bitmap>(rows);
+          func(BitRange(bits, first, last == -1 ? bits.size() : std::min(last, bits.size())));
+          return;
+        }
+      }
+    }
+
+    vector<int> toVector() const;
+    Bitmap toBitmap(int size) const;
+
+    // Results are always in ascending order
+    Selection operator&(const Selection &rhs) const;
+    Selection operator|(const Selection &rhs) const;
+
+    // Same indices in the same order, regardless of representation
+    friend bool operator==(const Selection &lhs, const Selection &rhs);
+
+    friend ostream& operator<<(ostream& os, const Selection &self);
+
+  private:
+    struct Range {
+      int begin;
+      int end;
+    };
+
+    variant<Range, vector<int>, Bitmap> rows;
+
+    // Cached, a bitmap would need a popcount otherwise
+    int selected = 0;
+};
@@ -0,0 +1,348 @@
+#include "storage.h"
+
+/////////////////////////// ColumnSegment //////////////////////////////////
+
+ColumnSegment::ColumnSegment(const Datatypes Type, const bool DictionaryEncoded, 
+                             const int TimePrecision, const int CharLength) : 
+  type(Type), buffer(makeBuffer(Type, DictionaryEncoded, TimePrecision, CharLength)) {}
+
+ColumnBuffer ColumnSegment::makeBuffer(const Datatypes type, const bool dictionaryEncoded,
+                                       const int timePrecision, const int charLength) {
+  // -1 means any precision is accepted, so keep everything
+  int precision = timePrecision == -1 ? 6 : timePrecision;
+
+  if (dictionaryEncoded) {
+    switch (type) {
+      case Datatypes::TEXT: return Dictionary<string>();
+      case Datatypes::VARCHAR: return Dictionary<Varchar>(charLength);
+      case Datatypes::CHAR: return Dictionary<SQLChar>(charLength);
+      default: {
+        cerr << "Dictionary encoding is only supported on string columns" << endl;
+        exit(5);
+      }
+    }
+  }
+
+  switch (type) {
+    case Datatypes::INT: return vector<int>();
+    case Datatypes::SMALLINT: return vector<int16_t>();
+    case Datatypes::BIGINT: return vector<int64_t>();
+    case Datatypes::FLOAT: return vector<float>();
+    case Datatypes::TEXT: return StringArena();
+    case Datatypes::VARCHAR: return CharArena<Varchar>(charLength);
+    case Datatypes::CHAR: return CharArena<SQLChar>(charLength);
+    case Datatypes::DATE: return PackedBuffer<Date>();
+    case Datatypes::TIME: return PackedBuffer<Time>({precision});
+    case Datatypes::DATETIME: return PackedBuffer<Datetime>({precision});
+
+    // A NULL column only ever holds nulls, so any buffer will do
+    case Datatypes::BOOL:
+    case Datatypes::NULLVALUE:
+    default:
+      return vector<uint8_t>();
+  }
+}
+
+int ColumnSegment::size() const {
+  return validity.size();
+}
+
+void ColumnSegment::reserve(int capacity) {
+  validity.reserve(capacity);
+  std::visit([capacity] (auto &buffer) {buffer.reserve(capacity);}, buffer);
+}
+
+Types ColumnSegment::get(int index) const {
+  if (isNull(index)) return Null;
+
+  return std::visit([index] (const auto &buffer) -> Types {
+    return fromStorage(buffer[index]);
+  }, buffer);
+}
+
+bool ColumnSegment::hasNulls() const {
+  return nullCount > 0;
+}
+
+int ColumnSegment::countNulls() const {
+  return nullCount;
+}
+
+const Bitmap& ColumnSegment::getValidity() const {
+  return validity;
+}
+
+const uint64_t* ColumnSegment::validityWords() const {
+  return hasNulls() ? validity.data().data() : nullptr;
+}
+
+bool ColumnSegment::isDictionaryEncoded() const {
+  return std::visit([] (const auto &buffer) {
+    return is_dictionary_v<decay_t<decltype(buffer)>>;
+  }, buffer);
+}
+
+// Null cells still take a (default constructed) slot so positions line up
+void ColumnSegment::push(const Types &value) {
+  bool null = ::isNull(value);
+
+  std::visit([&value, null] (auto &buffer) {
+    using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+    buffer.push_back(null ? Stored() : toStorage<Stored>(value));
+  }, buffer);
+
+  validity.push(!null);
+  nullCount += null;
+}
+
+void ColumnSegment::set(int index, const Types &value) {
+  bool null = ::isNull(value);
+
+  std::visit([&value, index, null] (auto &buffer) {
+    using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+    Stored stored = null ? Stored() : toStorage<Stored>(value);
+
+    if constexpr (is_vector_v<decay_t<decltype(buffer)>>) buffer[index] = stored;
+    else buffer.set(index, stored);
+  }, buffer);
+
+  nullCount += null - isNull(index);
+  validity.set(index, !null);
+}
+
+void ColumnSegment::pop() {
+  std::visit([] (auto &buffer) {buffer.pop_back();}, buffer);
+  nullCount -= isNull(size() - 1);
+  validity.pop();
+}
+
+void ColumnSegment::erase(int index) {
+  std::visit([index] (auto &buffer) {
+    if constexpr (is_vector_v<decay_t<decltype(buffer)>>) buffer.erase(buffer.begin() + index);
+    else buffer.erase(index);
+  }, buffer);
+  nullCount -= isNull(index);
+  validity.erase(index);
+}
+
+void ColumnSegment::pushString(string_view value) {
+  std::visit([value] (auto &buffer) {
+    using Buffer = decay_t<decltype(buffer)>;
+
+    if constexpr (is_same_v<Buffer, StringArena>) {
+      buffer.push_back(value);
+    }
+    else if constexpr (is_same_v<Buffer, CharArena<Varchar>> || is_same_v<Buffer, CharArena<SQLChar>>) {
+      buffer.push_back(value);
+    }
+    else if constexpr (is_same_v<Buffer, Dictionary<string>>) {
+      buffer.push_back(string(value));
+    }
+    else {
+      cerr << "Datatype does not match the type of column" << endl;
+      exit(5);
+    }
+  }, buffer);
+
+  validity.push(true);
+}
+
+void ColumnSegment::pushPacked(const int64_t value) {
+  std::visit([value] (auto &buffer) {
+    using Buffer = decay_t<decltype(buffer)>;
+
+    if constexpr (is_packed_v<Buffer>) {
+      buffer.push_packed(static_cast<typename Buffer::Physical>(value));
+    }
+    else {
+      cerr << "Datatype does not match the type of column" << endl;
+      exit(5);
+    }
+  }, buffer);
+
+  validity.push(true);
+}
+
+string ColumnSegment::getString(int index) const {
+  return std::visit([index] (const auto &buffer) -> string {
+    using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+    if constexpr (is_string_v<Stored>) {
+      return static_cast<string>(buffer[index]);
+    }
+
+    cerr << "Value with no conversion to string passed" << endl;
+    exit(9);
+  }, buffer);
+}
+
+string_view ColumnSegment::getStringView(int index) const {
+  return std::visit([index] (const auto &buffer) -> string_view {
+    using Buffer = decay_t<decltype(buffer)>;
+    using Stored = typename Buffer::value_type;
+
+    if constexpr (is_same_v<Buffer, StringArena> || is_same_v<Buffer, CharArena<Stored>>) {
+      return buffer.view(index);
+    }
+    else if constexpr (is_same_v<Stored, string>) {
+      return buffer[index];
+    }
+    else if constexpr (is_string_v<Stored>) {
+      return buffer[index].value;
+    }
+
+    cerr << "Value with no conversion to string passed" << endl;
+    exit(9);
+  }, buffer);
+}
+
+///////////////////////// ColumnSegment end //////////////////////////////////
+
+
+
+/////////////////////////// ColumnStorage //////////////////////////////////
+
+ColumnStorage::ColumnStorage(const Datatypes Type, const bool DictionaryEncoded, const int TimePrecision,
+                             const int CharLength, const int SegmentRows) : 
+  type(Type), dictionaryEncoded(DictionaryEncoded), timePrecision(TimePrecision), 
+  charLength(CharLength), segmentRows(SegmentRows) {
+  
+  if (segmentRows < 1) {
+    cerr << "Segments must hold at least one row" << endl;
+    exit(3);
+  }
+
+  // Fail on bad encodings right away rather than on the first push
+  segments.emplace_back(type, dictionaryEncoded, timePrecision, charLength);
+  starts.push_back(0);
+}
+
+int ColumnStorage::size() const {
+  return rows;
+}
+
+// Only the segments that the reserved rows will land on get space up front
+void ColumnStorage::reserve(int capacity) {
+  segments.reserve(capacity / segmentRows + 1);
+  starts.reserve(capacity / segmentRows + 1);
+
+  ColumnSegment &last = segments.back();
+  last.reserve(std::clamp(capacity - starts.back(), 0, segmentRows));
+}
+
+Types ColumnStorage::get(int index) const {
+  auto [segment, local] = locate(index);
+  return segments[segment].get(local);
+}
+
+bool ColumnStorage::hasNulls() const {
+  return nullCount > 0;
+}
+
+int ColumnStorage::countNulls() const {
+  return nullCount;
+}
+
+bool ColumnStorage::isDictionaryEncoded() const {
+  return dictionaryEncoded;
+}
+
+const vector<ColumnSegment>& ColumnStorage::getSegments() const {
+  return segments;
+}
+
+ColumnSegment& ColumnStorage::tail() {
+  if (segments.back().size() == segmentRows) {
+    starts.push_back(rows);
+    segments.emplace_back(type, dictionaryEncoded, timePrecision, charLength);
+  }
+
+  return segments.back();
+}
+
+// Keeps at least one segment around, so there is always a tail to push to
+void ColumnStorage::dropSegmentIfEmpty(int segment) {
+  if (segments[segment].size() != 0 || segments.size() == 1) return;
+
+  segments.erase(segments.begin() + segment);
+  starts.erase(starts.begin() + segment);
+}
+
+void ColumnStorage::push(const Types &value) {
+  tail().push(value);
+
+  ++rows;
+  nullCount += ::isNull(value);
+}
+
+void ColumnStorage::pushString(string_view value) {
+  tail().pushString(value);
+  ++rows;
+}
+
+void ColumnStorage::pushPacked(const int64_t value) {
+  tail().pushPacked(value);
+  ++rows;
+}
+
+void ColumnStorage::set(int index, const Types &value) {
+  auto [segment, local] = locate(index);
+
+  nullCount += ::isNull(value) - segments[segment].isNull(local);
+  segments[segment].set(local, value);
+}
+
+void ColumnStorage::pop() {
+  if (rows == 0) {
+    cerr << "Cannot pop from an empty column" << endl;
+    exit(10);
+  }
+
+  ColumnSegment &last = segments.back();
+
+  nullCount -= last.isNull(last.size() - 1);
+  last.pop();
+  --rows;
+
+  dropSegmentIfEmpty(segments.size() - 1);
+}
+
+// Only the segment holding index shifts its cells, later ones just move their start
+void ColumnStorage::erase(int index) {
+  auto [segment, local] = locate(index);
+
+  nullCount -= segments[segment].isNull(local);
+  segments[segment].erase(local);
+  --rows;
+
+  for (size_t i = segment + 1; i < starts.size(); ++i) {
+    --starts[i];
+  }
+
+  dropSegmentIfEmpty(segment);
+}
+
+int ColumnStorage::longestString(int from) const {
+  if (!isString(type)) return 0;
+
+  size_t longest = 0;
+  for (int i = from; i < size(); ++i) {
+    if (!isNull(i)) longest = std::max(longest, getStringView(i).size());
+  }
+
+  return longest;
+}
+
+string ColumnStorage::getString(int index) const {
+  auto [segment, local] = locate(index);
+  return segments[segment].getString(local);
+}
+
+string_view ColumnStorage::getStringView(int index) const {
+  auto [segment, local] = locate(index);
+  return segments[segment].getStringView(local);
+}
+
+///////////////////////// ColumnStorage end //////////////////////////////////
@@ -0,0 +1,334 @@
+#pragma once
+#include <vector>
+#include <variant>
+#include <cstdint>
+#include <string_view>
+#include <span>
+#include <algorithm>
+#include "datatypes.h"
+#include "arena.h"
+#include "bitmap.h"
+#include "selection.h"
+#include "dictionary.h"
+#include "packed.h"
+
+using namespace std;
+
+// Physical layout of a column. Every Datatypes gets its own contiguous buffer,
+// so an INT column is a plain vector<int> instead of a vector of Types variants,
+// a DATE column a plain array of day numbers, and TIME/DATETIME arrays of microseconds.
+// TEXT cells share one byte arena instead of owning a heap allocation each, and so
+// do VARCHAR/CHAR cells, whose declared length is kept once by the buffer.
+// Order mirrors Datatypes (NULLVALUE columns reuse the BOOL buffer), string
+// types can alternatively be dictionary encoded
+using ColumnBuffer = variant<
+  vector<uint8_t>,    //BOOL
+  vector<int>,        //INTEGER
+  vector<int16_t>,    //SMALLINT
+  vector<int64_t>,    //BIGINT
+  vector<float>,      //FLOAT
+  StringArena,        //TEXT
+  CharArena<Varchar>, //VARCHAR
+  CharArena<SQLChar>, //CHAR
+  PackedBuffer<Date>, //DATE
+  PackedBuffer<Time>,     //TIME
+  PackedBuffer<Datetime>, //DATETIME
+  Dictionary<string>,   //TEXT (dictionary encoded)
+  Dictionary<Varchar>,  //VARCHAR (dictionary encoded)
+  Dictionary<SQLChar>   //CHAR (dictionary encoded)
+>;
+
+// Type trait for the buffers that hold plain numbers (BOOL is excluded on purpose,
+// it has no numeric conversion in getNumeric)
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T>
+struct is_vector<vector<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_vector_v = is_vector<T>::value;
+
+template <typename T>
+struct is_numeric_storage : std::false_type {};
+
+template <typename T>
+constexpr bool is_numeric_storage_v = is_numeric_storage<T>::value;
+
+template<>
+struct is_numeric_storage<int> : std::true_type {};
+
+template<>
+struct is_numeric_storage<int16_t> : std::true_type {};
+
+template<>
+struct is_numeric_storage<int64_t> : std::true_type {};
+
+template<>
+struct is_numeric_storage<float> : std::true_type {};
+
+// One row group of a column: a typed buffer plus its validity. Indices are local
+// to the segment
+class ColumnSegment {
+  public:
+    ColumnSegment(const Datatypes Type, const bool DictionaryEncoded=false, 
+                  const int TimePrecision=-1, const int CharLength=-1);
+
+    int size() const;
+    void reserve(int capacity);
+
+    // Materializes a cell back into a Types. Prefer the typed accessors on hot paths
+    Types get(int index) const;
+
+    bool isNull(int index) const {
+      return !validity.test(index);
+    }
+
+    // O(1), lets columns without nulls skip null handling entirely
+    bool hasNulls() const;
+    int countNulls() const;
+    const Bitmap& getValidity() const;
+
+    // Validity words for the reduction kernels, nullptr when there are no nulls
+    const uint64_t* validityWords() const;
+
+    // Calls func(i - offset) for every i in run whose cell is not null. run is any
+    // iterable of indices (see Selection::visit)
+    template <typename Run, typename Func>
+    void forEachValid(const Run &run, const int offset, Func &&func) const {
+      if (!hasNulls()) {
+        for (int i : run) func(i - offset);
+        return;
+      }
+
+      for (int i : run) {
+        if (validity.test(i - offset)) func(i - offset);
+      }
+    }
+
+    void push(const Types &value);
+    void set(int index, const Types &value);
+
+    void pop();
+    void erase(int index);
+
+    // Appends a non null cell to a TEXT column, or a VARCHAR or CHAR one that isn't
+    // dictionary encoded, straight from its bytes, so string kernels (and the .csv
+    // loader) can fill their result without a Types (or string) per row
+    void pushString(string_view value);
+
+    // Appends a non null cell to a DATE, TIME or DATETIME column in its packed form
+    // (see Packing), so temporal kernels fill their result without a Types per row
+    void pushPacked(const int64_t value);
+
+    // Typed accessors that skip building a Types
+    string getString(int index) const;
+
+    // Like getString without the copy, CHAR cells come without their implied padding.
+    // Only valid until the column is modified
+    string_view getStringView(int index) const;
+
+    template <typename T>
+    enable_if_t<is_arithmetic_v<T>, T> getNumeric(int index) const {
+      return std::visit([index] (const auto &buffer) -> T {
+        using Stored = typename decay_t<decltype(buffer)>::value_type;
+
+        if constexpr (is_numeric_storage_v<Stored>) {
+          return static_cast<T>(buffer[index]);
+        }
+        else if constexpr (is_string_v<Stored>) {
+          return static_cast<T>(stod(static_cast<string>(buffer[index])));
+        }
+
+        cerr << "Value with no conversion to double passed" << endl;
+        exit(9);
+      }, buffer);
+    }
+
+    // Hands the typed buffer to func, so kernels can loop over primitive arrays
+    template <typename Func>
+    decltype(auto) visit(Func &&func) const {
+      return std::visit(std::forward<Func>(func), buffer);
+    }
+
+    bool isDictionaryEncoded() const;
+
+    Datatypes type;
+
+  private:
+    ColumnBuffer buffer;
+
+    // 1 = valid, 0 = NULL
+    Bitmap validity;
+    int nullCount = 0;
+
+    static ColumnBuffer makeBuffer(const Datatypes type, const bool dictionaryEncoded, 
+                                   const int timePrecision, const int charLength);
+};
+
+
+// Physical column: a directory of segments (row groups) of at most segmentRows
+// cells each. Appends only ever touch the last segment, so growing a column never
+// copies old cells, and erasing shifts cells within a single segment. Segments
+// are also the natural unit to split a scan across threads.
+// Indices are global unless stated otherwise
+class ColumnStorage {
+  public:
+    static constexpr int DEFAULT_SEGMENT_ROWS = 1 << 16;
+
+    ColumnStorage(const Datatypes Type, const bool DictionaryEncoded=false, 
+                  const int TimePrecision=-1, const int CharLength=-1,
+                  const int SegmentRows=DEFAULT_SEGMENT_ROWS);
+
+    int size() const;
+    void reserve(int capacity);
+
+    Types get(int index) const;
+
+    bool isNull(int index) const {
+      auto [segment, local] = locate(index);
+      return segments[segment].isNull(local);
+    }
+
+    bool hasNulls() const;
+    int countNulls() const;
+
+    // Calls func(i) for every selected index whose cell is not null
+    template <typename Func>
+    void forEachValid(const Selection &selection, Func &&func) const {
+      forEachRun(selection, [&func] (const ColumnSegment &segment, const auto &run, const int start) {
+        segment.forEachValid(run, start, [&func, start] (int local) {func(start + local);});
+      });
+    }
+
+    // Splits selection into runs that fall in the same segment, and calls
+    // func(segment, run, start) on each. run is an iterable of global indices (see
+    // Selection::visit), start is the global index of the segment's first cell.
+    // Kernels visit the segment's buffer once per run instead of once per cell
+    template <typename Func>
+    void forEachRun(const Selection &selection, Func &&func) const {
+      // Ranges and bitmaps are ascending, every segment just gets its slice of them
+      if (selection.kind() != Selection::Kind::LIST) {
+        int extent = selection.extent();
+
+        for (size_t segment = 0; segment < segments.size() && starts[segment] < extent; ++segment) {
+          int start = starts[segment];
+          selection.visit([&] (const auto &run) {func(segments[segment], run, start);}, 
+                          start, start + segments[segment].size());
+        }
+
+        return;
+      }
+
+      // Lists can come in any order, so runs end wherever the next index leaves the segment
+      selection.visit([&] (const auto &indices) {
+        if constexpr (is_same_v<decay_t<decltype(indices)>, span<const int>>) {
+          size_t begin = 0;
+
+          while (begin < indices.size()) {
+            int segment = locate(indices[begin]).first;
+            int start = starts[segment];
+            int end = start + segments[segment].size();
+
+            size_t stop = begin + 1;
+            while (stop < indices.size() && start <= indices[stop] && indices[stop] < end) ++stop;
+
+            func(segments[segment], indices.subspan(begin, stop - begin), start);
+            begin = stop;
+          }
+        }
+      });
+    }
+
+    // Calls func(segment, start) on every segment in order
+    template <typename Func>
+    void forEachSegment(Func &&func) const {
+      for (size_t i = 0; i < segments.size(); ++i) {
+        func(segments[i], starts[i]);
+      }
+    }
+
+    void push(const Types &value);
+    void set(int index, const Types &value);
+
+    void pop();
+    void erase(int index);
+
+    // Size of the largest string cell from index from onwards, so a batch of
+    // inserts can be checked against the declared length in one go. 0 for other columns
+    int longestString(int from=0) const;
+
+    void pushString(string_view value);
+    void pushPacked(const int64_t value);
+
+    string getString(int index) const;
+    string_view getStringView(int index) const;
+
+    template <typename T>
+    enable_if_t<is_arithmetic_v<T>, T> getNumeric(int index) const {
+      auto [segment, local] = locate(index);
+      return segments[segment].getNumeric<T>(local);
+    }
+
+    bool isDictionaryEncoded() const;
+
+    const vector<ColumnSegment>& getSegments() const;
+
+    Datatypes type;
+
+  private:
+    vector<ColumnSegment> segments;
+
+    // Global index of the first cell of every segment
+    vector<int> starts;
+
+    int rows = 0;
+    int nullCount = 0;
+
+    bool dictionaryEncoded;
+    int timePrecision;
+    int charLength;
+    int segmentRows;
+
+    // (segment, local index) holding global index. O(1) while every segment but the
+    // last is full, a binary search over starts once erases have shrunk some
+    pair<int, int> locate(int index) const {
+      int segment = index / segmentRows;
+
+      if (segment >= static_cast<int>(segments.size()) || index < starts[segment] ||
+          index >= starts[segment] + segments[segment].size()) {
+        segment = upper_bound(starts.begin(), starts.end(), index) - starts.begin() - 1;
+      }
+
+      return {segment, index - starts[segment]};
+    }
+
+    // Segment that takes the next push, opening a new one when the last is full
+    ColumnSegment& tail();
+    void dropSegmentIfEmpty(int segment);
+};
+
+// Converts a (non-null) cell into the value stored by the buffer of type T
+template <typename T>
+T toStorage(const Types &value) {
+  if constexpr (is_same_v<T, uint8_t>) {
+    if (holds_alternative<bool>(value)) return static_cast<uint8_t>(get<bool>(value));
+  }
+  else {
+    if (holds_alternative<T>(value)) return get<T>(value);
+  }
+
+  cerr << "Datatype does not match the type of column" << endl;
+  exit(5);
+}
+
+// Inverse of toStorage
+template <typename T>
+Types fromStorage(const T &value) {
+  if constexpr (is_same_v<T, uint8_t>) {
+    return Types(static_cast<bool>(value));
+  }
+  else {
+    return Types(value);
+  }
+}
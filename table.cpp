@@ -64,11 +64,11 @@ Table::Table () {};
 void Table::addColumn(const Column formedColumn, const string &name) {
   aliases.push(Alias(name));
 
-  table[name] = formedColumn;
+  table.insert_or_assign(name, formedColumn);
 }
 
 void Table::addColumn(const string &name, Datatypes type, string &unprocessedValues) {
-  Column formedColumn = commaSeparatedToColumn(type, unprocessedValues);
+  Column formedColumn = commaSeparatedToColumn(name, type, unprocessedValues);
 
   addColumn(formedColumn, name);
 }
@@ -78,27 +78,23 @@ void Table::deleteColumn(const string &name) {
 }
 
 void Table::renameColumn(const string &oldName, const string &newName) {
-  table[newName];
-  swap(table[oldName], table[newName]);
-  table.erase(oldName);
+  auto column = table.extract(oldName);
+  if (column.empty()) return;
+
+  table.insert_or_assign(newName, std::move(column.mapped()));
 }
 
-Column Table::commaSeparatedToColumn(const Datatypes type, string &values) {
+// Fields are parsed in place, into the column's storage, without a string or Types
+// each. Rows are counted from 0, the first field of the line
+Column Table::commaSeparatedToColumn(const string &name, const Datatypes type, string_view values) {
   Column col(type);
 
-  auto begin = values.begin(), end = std::find(values.begin(), values.end(), ',');
-
-  // Want everything to be self-contained in the loop. We know it is done when 
-  // there are no more , to find, so begin will be the same as end.
-  while (true) {
-    Types value = convertToVariant(string(begin, end), type);
-
-    col.push(value);
-
-    begin = end;
-    if (begin == values.end()) break;
-    end = std::find(begin + 1, values.end(), ',');
-  }
+  forEachField(values, [&] (string_view field, const int row) {
+    if (!col.pushField(field)) {
+      cerr << "Invalid value '" << field << "' in column " << name << ", row " << row << endl;
+      exit(3);
+    }
+  });
 
   return col;
 }
\ No newline at end of file
@@ -69,6 +69,7 @@ class Table{
 
     ////// Helper methods for data processing
 
-    // Takes in a full CSV line (past the first line) and creates a column from that
-    Column commaSeparatedToColumn(const Datatypes type, string &values); 
+    // Takes in a full CSV line (past the first line) and creates a column from that.
+    // Invalid values exit with code 3, giving the column and row they are at
+    Column commaSeparatedToColumn(const string &name, const Datatypes type, string_view values);
 };
\ No newline at end of file
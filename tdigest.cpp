@@ -0,0 +1,141 @@
+#include "tdigest.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+// k1 scale function: centroids may span one unit of k, which is narrow in q at the tails
+double scale(const double q, const double compression) {
+  return compression / (2 * M_PI) * std::asin(2 * q - 1);
+}
+
+double inverseScale(const double k, const double compression) {
+  if (k >= compression / 4) return 1;
+
+  return (std::sin(k * 2 * M_PI / compression) + 1) / 2;
+}
+
+} // namespace
+
+/////////////////////////// TDigest /////////////////////////////////
+
+TDigest::TDigest(double Compression) 
+  : compression(Compression), min(std::numeric_limits<double>::infinity()), 
+    max(-std::numeric_limits<double>::infinity()) {
+  if (!(compression >= 10)) {
+    cerr << "TDigest compression must be at least 10" << endl;
+    exit(3);
+  }
+}
+
+void TDigest::add(double value, double weight) {
+  if (std::isnan(value)) return;
+
+  unmerged.push_back({value, weight});
+  totalWeight += weight;
+  min = std::min(min, value);
+  max = std::max(max, value);
+
+  if (unmerged.size() >= static_cast<size_t>(compression) * 8) compress();
+}
+
+void TDigest::merge(const TDigest &other) {
+  unmerged.insert(unmerged.end(), other.centroids.begin(), other.centroids.end());
+  unmerged.insert(unmerged.end(), other.unmerged.begin(), other.unmerged.end());
+
+  totalWeight += other.totalWeight;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+
+  compress();
+}
+
+// One sorted pass: neighbours are folded together while the merged centroid stays
+// within one unit of the scale function
+void TDigest::compress() {
+  if (unmerged.empty()) return;
+
+  unmerged.insert(unmerged.end(), centroids.begin(), centroids.end());
+  std::sort(unmerged.begin(), unmerged.end(), [] (const Centroid &lhs, const Centroid &rhs) {
+    return lhs.mean < rhs.mean;
+  });
+
+  centroids.clear();
+
+  Centroid current = unmerged.front();
+  double weightBefore = 0;
+  double limit = inverseScale(scale(0, compression) + 1, compression);
+
+  for (size_t i = 1; i < unmerged.size(); ++i) {
+    const Centroid &next = unmerged[i];
+
+    if ((weightBefore + current.weight + next.weight) / totalWeight <= limit) {
+      current.mean += (next.mean - current.mean) * next.weight / (current.weight + next.weight);
+      current.weight += next.weight;
+      continue;
+    }
+
+    centroids.push_back(current);
+    weightBefore += current.weight;
+    limit = inverseScale(scale(weightBefore / totalWeight, compression) + 1, compression);
+    current = next;
+  }
+
+  centroids.push_back(current);
+  unmerged.clear();
+}
+
+// Every centroid sits at the middle of its weight, values in between are
+// interpolated. The ends interpolate towards the exact minimum and maximum
+double TDigest::quantile(double q) const {
+  if (q < 0 || q > 1) {
+    cerr << "Quantile must be between 0 and 1" << endl;
+    exit(3);
+  }
+
+  if (totalWeight == 0) return std::numeric_limits<double>::quiet_NaN();
+
+  if (!unmerged.empty()) {
+    TDigest compressed = *this;
+    compressed.compress();
+    return compressed.quantile(q);
+  }
+
+  if (q == 0) return min;
+  if (q == 1) return max;
+
+  const double target = q * totalWeight;
+
+  const Centroid &first = centroids.front();
+  if (target < first.weight / 2) {
+    return min + (first.mean - min) * target / (first.weight / 2);
+  }
+
+  double weightBefore = 0;
+
+  for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+    double center = weightBefore + centroids[i].weight / 2;
+    double nextCenter = weightBefore + centroids[i].weight + centroids[i + 1].weight / 2;
+
+    if (target < nextCenter) {
+      double fraction = (target - center) / (nextCenter - center);
+      return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * fraction;
+    }
+
+    weightBefore += centroids[i].weight;
+  }
+
+  const Centroid &last = centroids.back();
+  double center = totalWeight - last.weight / 2;
+  if (last.weight / 2 == 0) return max;
+
+  return last.mean + (max - last.mean) * std::min(1.0, (target - center) / (last.weight / 2));
+}
+
+double TDigest::getCount() const {
+  return totalWeight;
+}
+
+///////////////////////// TDigest end ///////////////////////////////
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Merging t-digest sketch for approximate quantiles. Values are summarized by
+// centroids (mean, weight), which are kept small near the tails (q close to 0 or 1)
+// and large in the middle, so p99 stays accurate with a bounded number of centroids
+// (around compression of them). Digests merge into the digest of the union of their
+// values, so partial digests (per segment, per thread...) can be combined
+class TDigest {
+  public:
+    static constexpr double DEFAULT_COMPRESSION = 100;
+
+    TDigest(double Compression=DEFAULT_COMPRESSION);
+
+    void add(double value, double weight=1);
+    void merge(const TDigest &other);
+
+    // Interpolates between centroids; exact at the minimum and maximum. NaN if empty
+    double quantile(double q) const;
+
+    double getCount() const;
+
+  private:
+    struct Centroid {
+      double mean;
+      double weight;
+    };
+
+    double compression;
+    double totalWeight = 0;
+    double min;
+    double max;
+
+    vector<Centroid> centroids;
+
+    // Values not merged into the centroids yet, flushed once it fills up
+    vector<Centroid> unmerged;
+
+    void compress();
+};
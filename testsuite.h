@@ -4,6 +4,8 @@
 #include "gtest/gtest.h" // Or your favorite C++ testing framework
 #include <numeric>
 #include <stdexcept>
+#include <regex>
+#include <tuple>
 
 #define C_GREEN   "\x1B[32m"
 #define C_RED     "\x1B[31m"
@@ -1255,6 +1257,1421 @@ TEST_F(ColumnTest, IndicesMeetingCondition) {
     EXPECT_EQ(not_equal_to_5, expected_neq);
 }
 
+TEST_F(ColumnTest, IndicesMeetingConditionMixedTypes) {
+    std::vector<Types> data = {1.5f, std::monostate{}, 10.0f, -3.0f};
+    Column col(data, Datatypes::FLOAT);
+
+    auto at_least_1 = col.indicesMeetingCondition(Types(1), std::greater_equal<Types>());
+    std::vector<int> expected_ge = {0, 2};
+    EXPECT_EQ(at_least_1, expected_ge);
+
+    // NULL cells keep the semantics of comparing Types directly
+    auto not_10 = col.indicesMeetingCondition(Types(int64_t(10)), std::not_equal_to<Types>());
+    std::vector<int> expected_neq = {0, 1, 3};
+    EXPECT_EQ(not_10, expected_neq);
+}
+
+//##############################################################################
+// STORAGE TESTS
+//##############################################################################
+
+TEST_F(ColumnTest, TypedStorageRoundTrip) {
+    Column small_col(Datatypes::SMALLINT);
+    small_col.push(int16_t(7));
+    small_col.push(std::monostate{});
+    small_col.push(int16_t(-3));
+    EXPECT_EQ(small_col.size(), 3);
+    EXPECT_EQ(std::get<int16_t>(small_col[0]), 7);
+    EXPECT_TRUE(isNull(small_col[1]));
+    EXPECT_EQ(std::get<int16_t>(small_col[-1]), -3);
+
+    small_col.pop();
+    EXPECT_EQ(small_col.size(), 2);
+    small_col.pop();
+    small_col.pop();
+    EXPECT_EQ(small_col.size(), 0);
+    EXPECT_EXIT(small_col.pop(), ::testing::ExitedWithCode(10), "");
+
+    Column bool_col(Datatypes::BOOL);
+    bool_col.push(true);
+    bool_col.push(false);
+    EXPECT_TRUE(std::get<bool>(bool_col[0]));
+    EXPECT_FALSE(std::get<bool>(bool_col[1]));
+
+    std::vector<Types> dates = {Date(2024, 2, 29), std::monostate{}};
+    Column dt_col(dates, Datatypes::DATE);
+    EXPECT_EQ(std::get<Date>(dt_col[0]), Date(2024, 2, 29));
+    EXPECT_TRUE(isNull(dt_col[1]));
+
+    std::vector<Types> cells = static_cast<std::vector<Types>>(dt_col);
+    EXPECT_EQ(cells.size(), 2u);
+}
+
+TEST_F(ColumnTest, ValidityTracksNulls) {
+    std::vector<Types> data = {1, std::monostate{}, 3, std::monostate{}, 5};
+    Column col(data, Datatypes::INT);
+    auto indices = create_indices(col.size());
+    EXPECT_EQ(col.count(indices), 3);
+
+    col.update(1, 2);
+    EXPECT_EQ(col.count(indices), 4);
+
+    col.erase(3);
+    EXPECT_EQ(col.size(), 4);
+    EXPECT_EQ(col.count(create_indices(col.size())), 4);
+    EXPECT_EQ(col[3], Types(5));
+}
+
+TEST_F(ColumnTest, DictionaryEncodedStrings) {
+    ColumnConstraints constraints;
+    constraints.DictionaryEncoded = true;
+
+    std::vector<Types> data = {std::string("open"), std::string("closed"), std::monostate{},
+                               std::string("open"), std::string("pending"), std::string("open")};
+    Column col(data, Datatypes::TEXT, constraints);
+    auto indices = create_indices(col.size());
+
+    EXPECT_EQ(col[3], Types(std::string("open")));
+    EXPECT_TRUE(isNull(col[2]));
+
+    auto open_rows = col.indicesMeetingCondition(Types(std::string("open")), std::equal_to<Types>());
+    std::vector<int> expected_open = {0, 3, 5};
+    EXPECT_EQ(open_rows, expected_open);
+
+    auto before_p = col.indicesMeetingCondition(Types(std::string("p")), std::less<Types>());
+    std::vector<int> expected_before = {0, 1, 3, 5};
+    EXPECT_EQ(before_p, expected_before);
+
+    EXPECT_EQ(col.countDistinct(indices), 3);
+
+    Column upper_col = col.upper(indices);
+    EXPECT_EQ(std::get<std::string>(upper_col[4]), "PENDING");
+    EXPECT_TRUE(isNull(upper_col[2]));
+
+    col.update(1, std::string("open"));
+    col.erase(4);
+    EXPECT_EQ(col.countDistinct(create_indices(col.size())), 1);
+
+    // CHAR values are one entry whatever their own padding, and read back at the
+    // column's length, same as the arena layout
+    Dictionary<SQLChar> entries(5);
+    entries.push_back(SQLChar(3, "a"));
+    entries.push_back(SQLChar(5, "a"));
+    EXPECT_EQ(entries.getEntries().size(), 1u);
+    EXPECT_EQ(entries.find("a"), 0);
+
+    ColumnConstraints charFive;
+    charFive.CharLength = 5;
+    std::vector<Types> chars = {SQLChar(3, "a"), SQLChar(5, "a"), SQLChar(4, "b")};
+    Column plain(chars, Datatypes::CHAR, charFive);
+    charFive.DictionaryEncoded = true;
+    Column encoded(chars, Datatypes::CHAR, charFive);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(static_cast<std::string>(std::get<SQLChar>(encoded[i])), 
+                  static_cast<std::string>(std::get<SQLChar>(plain[i])));
+    }
+    EXPECT_EQ(static_cast<std::string>(std::get<SQLChar>(encoded[0])), "a    ");
+    EXPECT_EQ(encoded.countDistinct(create_indices(3)), 2);
+}
+
+TEST_F(ColumnTest, DateColumnStoresEpochs) {
+    std::vector<Types> data = {Date(2024, 2, 29), Date(1999, 12, 31), std::monostate{}, Date(2025, 1, 1)};
+    Column col(data, Datatypes::DATE);
+
+    Date leap = std::get<Date>(col[0]);
+    EXPECT_EQ(leap.year, 2024);
+    EXPECT_EQ(leap.month, 2);
+    EXPECT_EQ(leap.day, 29);
+
+    auto since_2000 = col.indicesMeetingCondition(Types(Date(2000, 1, 1)), std::greater_equal<Types>());
+    std::vector<int> expected_since = {0, 3};
+    EXPECT_EQ(since_2000, expected_since);
+
+    auto exactly = col.indicesMeetingCondition(Types(Date("1999-12-31")), std::equal_to<Types>());
+    std::vector<int> expected_exactly = {1};
+    EXPECT_EQ(exactly, expected_exactly);
+
+    col.update(2, Date(2000, 1, 1));
+    col.erase(0);
+    EXPECT_EQ(std::get<Date>(col[1]), Date(2000, 1, 1));
+    EXPECT_EQ(std::get<Date>(col[-1]).epoch, Date(2025, 1, 1).epoch);
+}
+
+TEST_F(ColumnTest, TimeAndDatetimeStoreMicroseconds) {
+    ColumnConstraints constraints;
+    constraints.TimePrecision = 3;
+
+    std::vector<Types> times = {Time(14, 30, 5, 123, 3), std::monostate{}, Time(9, 0, 0, 0, 3)};
+    Column time_col(times, Datatypes::TIME, constraints);
+    Time restored = std::get<Time>(time_col[0]);
+    EXPECT_EQ(restored, Time(14, 30, 5, 123, 3));
+    EXPECT_EQ(restored.fraction, 123u);
+    EXPECT_EQ(restored.precision, 3u);
+
+    auto indices = create_indices(time_col.size());
+    Column minutes = time_col.extract(indices, TimeComponents::MINUTES);
+    EXPECT_FLOAT_EQ(std::get<float>(minutes[0]), 30.0f);
+    EXPECT_TRUE(isNull(minutes[1]));
+    Column fractions = time_col.extract(indices, TimeComponents::FRACTIONS);
+    EXPECT_FLOAT_EQ(std::get<float>(fractions[0]), 123000.0f);
+
+    std::vector<Types> stamps = {Datetime("2024-07-29 10:30:00"), Datetime("2024-07-28 23:59:59"),
+                                 Datetime("2024-07-29 10:30:01")};
+    date_col = Column(stamps, Datatypes::DATETIME);
+    auto after = date_col.indicesMeetingCondition(Types(Datetime("2024-07-29 10:30:00")), std::greater<Types>());
+    std::vector<int> expected_after = {2};
+    EXPECT_EQ(after, expected_after);
+
+    Column hours = date_col.extract(create_indices(date_col.size()), TimeComponents::HOURS);
+    EXPECT_FLOAT_EQ(std::get<float>(hours[1]), 23.0f);
+    Column days = date_col.extract(create_indices(date_col.size()), DateComponents::DAYS);
+    EXPECT_FLOAT_EQ(std::get<float>(days[1]), 28.0f);
+}
+
+TEST(DatetimeTest, FixedPointArithmetic) {
+    Datetime start("2025-06-21 10:00:00");
+    EXPECT_EQ(start.datetimeAdd(25, TimeComponents::HOURS), Datetime("2025-06-22 11:00:00"));
+    EXPECT_EQ(start.datetimeSub(49, TimeComponents::HOURS), Datetime("2025-06-19 09:00:00"));
+    EXPECT_EQ(start.datetimeAdd(1500000, TimeComponents::FRACTIONS), Datetime("2025-06-21 10:00:01.5"));
+
+    EXPECT_EQ(dateDiff(Datetime("2025-06-21 10:59:59"), Datetime("2025-06-21 11:00:00"), TimeComponents::HOURS), 1);
+    EXPECT_EQ(dateDiff(Datetime("2020-01-01 00:00:00"), Datetime("2021-01-01 00:00:00"), TimeComponents::HOURS), 8784);
+
+    Datetime round_trip = microsToDatetime(datetimeToMicros(Datetime("2024-02-29 23:59:59.999999")));
+    EXPECT_EQ(round_trip, Datetime("2024-02-29 23:59:59.999999"));
+}
+
+TEST(BitmapTest, PushEraseAndCount) {
+    Bitmap bits;
+    for (int i = 0; i < 130; ++i) bits.push(i % 3 == 0);
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.count(), 44);
+
+    // Erasing before a word boundary has to carry bits across words
+    bits.erase(0);
+    EXPECT_EQ(bits.size(), 129);
+    EXPECT_EQ(bits.count(), 43);
+    for (int i = 0; i < 129; ++i) EXPECT_EQ(bits.test(i), (i + 1) % 3 == 0);
+
+    Bitmap ones(129, true);
+    ones &= bits;
+    EXPECT_EQ(ones.count(), 43);
+
+    while (bits.size() > 64) bits.pop();
+    EXPECT_EQ(bits.count(), 21);
+    EXPECT_FALSE(bits.all());
+    EXPECT_TRUE(Bitmap(70, true).all());
+}
+
+TEST(SQLCharTest, PaddingIsImplied) {
+    SQLChar a(10, "ab");
+    EXPECT_EQ(a.value, "ab");
+    EXPECT_EQ(static_cast<std::string>(a), "ab        ");
+    EXPECT_EQ(a.getLength(), 10);
+
+    std::ostringstream out;
+    out << a << '|';
+    EXPECT_EQ(out.str(), "ab        |");
+
+    // Trailing spaces are insignificant between CHARs of any length
+    EXPECT_TRUE(a == SQLChar(4, "ab  "));
+    EXPECT_TRUE(SQLChar(3, "ab") < SQLChar(3, "ab!"));
+    EXPECT_TRUE(SQLChar(3, "ab\t") < SQLChar(3, "ab"));
+    EXPECT_EQ(comparePadded("ab", "ab   "), 0);
+}
+
+TEST_F(ColumnTest, CharColumnsKeepLengthOnce) {
+    ColumnConstraints constraints;
+    constraints.CharLength = 8;
+
+    std::vector<Types> data = {SQLChar(8, "ab"), std::monostate{}, SQLChar(3, "xyz")};
+    Column chars(data, Datatypes::CHAR, constraints);
+
+    // Cells come back with the column's length, whatever they were built with
+    EXPECT_EQ(std::get<SQLChar>(chars[2]).length, 8);
+    EXPECT_EQ(static_cast<std::string>(std::get<SQLChar>(chars[0])), "ab      ");
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(chars[1]));
+
+    Column varchars(Datatypes::VARCHAR, constraints);
+    varchars.push(Varchar("fits"));
+    varchars.push(Varchar(8, "exactly8"));
+    EXPECT_EQ(std::get<Varchar>(varchars[0]).value, "fits");
+    EXPECT_EQ(std::get<Varchar>(varchars[1]).length, 8);
+    EXPECT_EQ(std::get<int>(varchars.length({0, 1})[1]), 8);
+}
+
+TEST_F(ColumnTest, SegmentedStorageAcrossBoundaries) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 4;
+
+    Column col(Datatypes::INT, constraints);
+    for (int i = 0; i < 10; ++i) col.push(i % 3 == 0 ? Types(Null) : Types(i));
+    EXPECT_EQ(col.size(), 10);
+
+    // Erasing shrinks one segment, later indices have to be found through the directory
+    col.erase(1);
+    col.erase(1);
+    col.erase(1);
+    EXPECT_EQ(col.size(), 7);
+    EXPECT_EQ(col[0], Types(Null));
+    EXPECT_EQ(col[1], Types(4));
+    EXPECT_EQ(col[6], Types(Null));
+
+    auto indices = create_indices(col.size());
+    EXPECT_DOUBLE_EQ(col.sum(indices), 4 + 5 + 7 + 8);
+    EXPECT_EQ(col.count(indices), 4);
+    EXPECT_EQ(col.indicesMeetingCondition(Types(5), std::greater<Types>()), std::vector<int>({4, 5}));
+
+    col.pop();
+    col.push(11);
+    EXPECT_EQ(col[-1], Types(11));
+
+    constraints.DictionaryEncoded = true;
+    std::vector<Types> data = {"a", "b", "a", "c", "b", "a", "d", Null, "a"};
+    Column text(data, Datatypes::TEXT, constraints);
+    auto textIndices = create_indices(text.size());
+
+    EXPECT_EQ(text.countDistinct(textIndices), 4);
+    EXPECT_EQ(text.indicesMeetingCondition(Types("a"), std::equal_to<Types>()), std::vector<int>({0, 2, 5, 8}));
+    EXPECT_EQ(std::get<std::string>(text.upper({8, 6, 0})[1]), "D");
+}
+
+TEST_F(ColumnTest, SelectionsAndPredicateChaining) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 64;
+
+    std::vector<Types> data;
+    for (int i = 0; i < 200; ++i) data.push_back(i % 7 == 0 ? Types(Null) : Types(i));
+    Column col(data, Datatypes::INT, constraints);
+
+    // Full scans need no index list at all
+    Selection everything = Selection::all(col.size());
+    EXPECT_EQ(everything.kind(), Selection::Kind::RANGE);
+    EXPECT_EQ(col.count(everything), 200 - 29);
+    EXPECT_DOUBLE_EQ(col.sum(Selection::range(190, 200)), 1945 - 196);
+
+    // Dense results stay bitmaps, sparse ones become lists
+    Selection above = col.indicesMeetingCondition(Types(100), std::greater<Types>());
+    Selection below = col.indicesMeetingCondition(Types(110), std::less<Types>());
+    Selection rare = col.indicesMeetingCondition(Types(150), std::equal_to<Types>());
+    EXPECT_EQ(above.kind(), Selection::Kind::BITMAP);
+    EXPECT_EQ(rare.kind(), Selection::Kind::LIST);
+    EXPECT_EQ(rare, std::vector<int>({150}));
+
+    Selection between = above & below;
+    EXPECT_EQ(between, std::vector<int>({101, 102, 103, 104, 106, 107, 108, 109}));
+    EXPECT_EQ(col.count(between), 8);
+    EXPECT_EQ((rare | Selection({3})).toVector(), std::vector<int>({3, 150}));
+
+    // Lists keep their order
+    Column picked = col.round({150, 3, 101}, 0);
+    EXPECT_FLOAT_EQ(std::get<float>(picked[0]), 150.0f);
+    EXPECT_FLOAT_EQ(std::get<float>(picked[1]), 3.0f);
+}
+
+template <typename T>
+void expectKernelMatchesScalar(const std::vector<T> &values, T value) {
+    const std::pair<CompareOp, std::function<bool(T, T)>> ops[] = {
+        {CompareOp::EQ, std::equal_to<T>()}, {CompareOp::NE, std::not_equal_to<T>()},
+        {CompareOp::LT, std::less<T>()}, {CompareOp::LE, std::less_equal<T>()},
+        {CompareOp::GT, std::greater<T>()}, {CompareOp::GE, std::greater_equal<T>()}
+    };
+
+    for (const auto &[op, comp] : ops) {
+        std::vector<uint64_t> out((values.size() + 63) / 64, ~uint64_t(0));
+        compareValues(values.data(), values.size(), value, op, out.data());
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            EXPECT_EQ((out[i / 64] >> (i % 64)) & 1, comp(values[i], value)) << "index " << i;
+        }
+        if (values.size() % 64) {
+            EXPECT_EQ(out.back() >> (values.size() % 64), 0u);
+        }
+    }
+}
+
+TEST(FilterKernelTest, MatchesScalarComparisons) {
+    std::vector<int32_t> ints;
+    std::vector<int16_t> shorts;
+    std::vector<int64_t> longs;
+    std::vector<float> floats;
+    std::vector<uint8_t> bytes;
+
+    // 150 values: two full words plus a tail
+    for (int i = 0; i < 150; ++i) {
+        ints.push_back((i * 37) % 101 - 50);
+        shorts.push_back(static_cast<int16_t>((i * 53) % 211 - 105));
+        longs.push_back((int64_t(i) * 7919 % 97 - 48) * (int64_t(1) << 40));
+        floats.push_back(i % 13 == 0 ? NAN : (i % 29) - 14.5f);
+        bytes.push_back(static_cast<uint8_t>(i * 17));
+    }
+
+    expectKernelMatchesScalar<int32_t>(ints, 3);
+    expectKernelMatchesScalar<int16_t>(shorts, -7);
+    expectKernelMatchesScalar<int64_t>(longs, int64_t(5) << 40);
+    expectKernelMatchesScalar<float>(floats, 0.5f);
+    expectKernelMatchesScalar<uint8_t>(bytes, 136);
+}
+
+TEST_F(ColumnTest, IndicesMeetingConditionKernels) {
+    std::vector<Types> data = {int16_t(3), Null, int16_t(-4), int16_t(10), int16_t(3)};
+    Column col(data, Datatypes::SMALLINT);
+
+    EXPECT_EQ(col.indicesMeetingCondition(Types(3), std::less_equal<Types>()), std::vector<int>({0, 2, 4}));
+    // Not representable as SMALLINT, so compared as doubles
+    EXPECT_EQ(col.indicesMeetingCondition(Types(2.5f), std::greater<Types>()), std::vector<int>({0, 3, 4}));
+    EXPECT_EQ(col.indicesMeetingCondition(Types(100000), std::not_equal_to<Types>()), std::vector<int>({0, 1, 2, 3, 4}));
+
+    std::vector<Types> flags = {true, false, Null, true};
+    Column bools(flags, Datatypes::BOOL);
+    EXPECT_EQ(bools.indicesMeetingCondition(Types(true), std::equal_to<Types>()), std::vector<int>({0, 3}));
+    EXPECT_EQ(bools.indicesMeetingCondition(Types(true), std::not_equal_to<Types>()), std::vector<int>({1, 2}));
+
+    // Past 2^53 BIGINT cells round when made doubles: a FLOAT compares as before the
+    // kernels, as doubles, while a BIGINT compares exactly
+    const int64_t boundary = int64_t(1) << 53;
+    std::vector<Types> longs = {boundary - 1, boundary, boundary + 1, boundary + 2};
+    Column bigints(longs, Datatypes::BIGINT);
+    EXPECT_EQ(bigints.indicesMeetingCondition(Types(static_cast<float>(boundary)), std::equal_to<Types>()), 
+              std::vector<int>({1, 2}));
+    EXPECT_EQ(bigints.indicesMeetingCondition(Types(static_cast<float>(boundary)), std::greater<Types>()), 
+              std::vector<int>({3}));
+    EXPECT_EQ(bigints.indicesMeetingCondition(Types(boundary), std::equal_to<Types>()), std::vector<int>({1}));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(bigints.meetsCondition(i, Types(static_cast<float>(boundary)), std::less<Types>()), i == 0);
+    }
+}
+
+TEST(AggregateStateTest, MergedPartialsMatchOneState) {
+    // Large offset: the naive sum of squares would lose the variance entirely
+    std::vector<double> values = {1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16, 1e9 + 10};
+
+    AggregateState whole, left, right;
+    for (int i = 0; i < (int)values.size(); ++i) {
+        whole.add(values[i]);
+        (i < 2 ? left : right).add(values[i]);
+    }
+    left.merge(right);
+
+    EXPECT_EQ(left.count, 5);
+    EXPECT_DOUBLE_EQ(whole.variance(), 18);
+    EXPECT_NEAR(left.variance(), whole.variance(), 1e-6);
+    EXPECT_DOUBLE_EQ(left.mean, whole.mean);
+    EXPECT_DOUBLE_EQ(left.min, 1e9 + 4);
+    EXPECT_DOUBLE_EQ(left.max, 1e9 + 16);
+
+    AggregateState empty;
+    empty.merge(whole);
+    EXPECT_DOUBLE_EQ(empty.standardDeviation(), whole.standardDeviation());
+}
+
+TEST_F(ColumnTest, AggregateInOnePass) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 3;
+
+    Column col(Datatypes::INT, constraints);
+    for (Types cell : {Types(2), Types(Null), Types(4), Types(4), Types(4), Types(Null), Types(5), Types(5), Types(7), Types(9)}) {
+        col.push(cell);
+    }
+
+    auto indices = create_indices(col.size());
+    AggregateState all = col.aggregate(indices);
+    EXPECT_EQ(all.count, 8);
+    EXPECT_DOUBLE_EQ(all.sum, 40);
+    EXPECT_DOUBLE_EQ(all.avg(), 5);
+    EXPECT_DOUBLE_EQ(all.min, 2);
+    EXPECT_DOUBLE_EQ(all.max, 9);
+    EXPECT_DOUBLE_EQ(all.variance(), 4);
+    EXPECT_DOUBLE_EQ(all.standardDeviation(), 2);
+
+    EXPECT_DOUBLE_EQ(col.avg(indices), 5);
+    EXPECT_DOUBLE_EQ(col.standardDeviation(indices), 2);
+    EXPECT_EQ(col.aggregate(indices, Aggregate::COUNT).count, col.count(indices));
+
+    AggregateState some = col.aggregate(Selection::range(2, 5), Aggregate::SUM | Aggregate::MAX);
+    EXPECT_EQ(some.count, 3);
+    EXPECT_DOUBLE_EQ(some.sum, 12);
+    EXPECT_DOUBLE_EQ(some.max, 4);
+}
+
+template <typename T>
+void expectReductionMatchesScalar(const std::vector<T> &values, const std::vector<uint64_t> &validity) {
+    // Unaligned bounds, so stretches start and end mid word
+    const std::pair<int, int> bounds[] = {{0, (int)values.size()}, {3, (int)values.size() - 5}, {70, 130}, {64, 64}};
+
+    for (const auto &[first, last] : bounds) {
+        for (const uint64_t *valid : {(const uint64_t *)nullptr, validity.data()}) {
+            double sum = 0;
+            int folded = 0;
+            T low = std::numeric_limits<T>::max(), high = std::numeric_limits<T>::lowest();
+
+            for (int i = first; i < last; ++i) {
+                if (valid && !((valid[i / 64] >> (i % 64)) & 1)) continue;
+                sum += values[i];
+                ++folded;
+                low = std::min(low, values[i]);
+                high = std::max(high, values[i]);
+            }
+
+            T kernelLow = std::numeric_limits<T>::max(), kernelHigh = std::numeric_limits<T>::lowest();
+            EXPECT_EQ(minMaxValues(values.data(), first, last, valid, kernelLow, kernelHigh), folded);
+            EXPECT_EQ(countValid(first, last, valid), folded);
+            EXPECT_EQ(kernelLow, low);
+            EXPECT_EQ(kernelHigh, high);
+            EXPECT_DOUBLE_EQ(sumValues(values.data(), first, last, valid), sum);
+        }
+    }
+}
+
+TEST(ReduceKernelTest, MatchesScalarReductions) {
+    std::vector<int32_t> ints;
+    std::vector<int16_t> shorts;
+    std::vector<int64_t> longs;
+    std::vector<float> floats;
+
+    for (int i = 0; i < 200; ++i) {
+        ints.push_back((i * 37) % 101 - 50);
+        shorts.push_back(static_cast<int16_t>((i * 53) % 211 - 105));
+        longs.push_back((int64_t(i) * 7919 % 97 - 48) * (int64_t(1) << 40));
+        floats.push_back((i % 29) - 14.5f);
+    }
+
+    // One fully valid word, then holes
+    std::vector<uint64_t> validity = {~uint64_t(0), 0xF0F0F0F0F0F0F0F0, 0, 0x5555555555555555};
+
+    expectReductionMatchesScalar(ints, validity);
+    expectReductionMatchesScalar(shorts, validity);
+    expectReductionMatchesScalar(longs, validity);
+    expectReductionMatchesScalar(floats, validity);
+}
+
+TEST(ReduceKernelTest, IntegerSumsDoNotOverflow) {
+    std::vector<int64_t> longs(9, std::numeric_limits<int64_t>::max());
+    longs.push_back(std::numeric_limits<int64_t>::min());
+    EXPECT_DOUBLE_EQ(sumValues(longs.data(), 0, 10, nullptr), 8 * 9223372036854775807.0 - 1);
+
+    std::vector<int32_t> ints(1000, std::numeric_limits<int32_t>::min());
+    EXPECT_DOUBLE_EQ(sumValues(ints.data(), 0, 1000, nullptr), 1000 * -2147483648.0);
+
+    std::vector<int16_t> shorts(1000, std::numeric_limits<int16_t>::max());
+    EXPECT_DOUBLE_EQ(sumValues(shorts.data(), 0, 1000, nullptr), 1000 * 32767.0);
+
+    // Pairwise: a float accumulator would stop growing long before 1e7
+    std::vector<float> tenths(10000000, 0.1f);
+    EXPECT_NEAR(sumValues(tenths.data(), 0, (int)tenths.size(), nullptr), 1e6, 1);
+}
+
+TEST(ReduceKernelTest, NaNsAreNotFolded) {
+    std::vector<float> nans(100, NAN);
+    std::vector<uint64_t> validity = {0xF0F0F0F0F0F0F0F0, 0xF};
+
+    for (const uint64_t *valid : {(const uint64_t *)nullptr, (const uint64_t *)validity.data()}) {
+        float low = std::numeric_limits<float>::max(), high = std::numeric_limits<float>::lowest();
+        EXPECT_EQ(minMaxValues(nans.data(), 0, 100, valid, low, high), 0);
+        EXPECT_EQ(low, std::numeric_limits<float>::max());
+        EXPECT_EQ(high, std::numeric_limits<float>::lowest());
+    }
+
+    nans[70] = 2.5f;
+    float low = std::numeric_limits<float>::max(), high = std::numeric_limits<float>::lowest();
+    EXPECT_EQ(minMaxValues(nans.data(), 0, 100, nullptr, low, high), 1);
+    EXPECT_EQ(low, 2.5f);
+    EXPECT_EQ(high, 2.5f);
+}
+
+TEST_F(ColumnTest, AggregateSkipsAllNaNSegments) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 4;
+
+    // The first segment only holds NaNs, it must not bring in its sentinels
+    Column col(Datatypes::FLOAT, constraints);
+    for (Types cell : {Types(NAN), Types(NAN), Types(NAN), Types(NAN), Types(1.5f), Types(-2.0f)}) col.push(cell);
+
+    AggregateState all = col.aggregate(create_indices(col.size()), Aggregate::MIN | Aggregate::MAX | Aggregate::COUNT);
+    EXPECT_EQ(all.count, 6);
+    EXPECT_DOUBLE_EQ(all.min, -2);
+    EXPECT_DOUBLE_EQ(all.max, 1.5);
+
+    AggregateState nansOnly = col.aggregate(Selection::range(0, 4), Aggregate::MIN | Aggregate::MAX);
+    EXPECT_EQ(nansOnly.count, 4);
+    EXPECT_EQ(nansOnly.min, std::numeric_limits<double>::max());
+    EXPECT_EQ(nansOnly.max, std::numeric_limits<double>::lowest());
+}
+
+TEST_F(ColumnTest, ReductionsOnDenseRuns) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 100;
+
+    Column col(Datatypes::BIGINT, constraints);
+    for (int i = 0; i < 250; ++i) col.push(i % 7 == 0 ? Types(Null) : Types(int64_t(i) - 100));
+
+    double sum = 0, low = 1e18, high = -1e18;
+    for (int i = 10; i < 240; ++i) {
+        if (i % 7 == 0) continue;
+        sum += i - 100;
+        low = std::min(low, i - 100.0);
+        high = std::max(high, i - 100.0);
+    }
+
+    EXPECT_DOUBLE_EQ(col.sum(Selection::range(10, 240)), sum);
+    EXPECT_DOUBLE_EQ(col.min(Selection::range(10, 240)), low);
+    EXPECT_DOUBLE_EQ(col.max(Selection::range(10, 240)), high);
+
+    AggregateState state = col.aggregate(Selection::range(10, 240), Aggregate::COUNT | Aggregate::SUM | Aggregate::MIN);
+    EXPECT_EQ(state.count, col.count(Selection::range(10, 240)));
+    EXPECT_DOUBLE_EQ(state.sum, sum);
+    EXPECT_DOUBLE_EQ(state.min, low);
+}
+
+TEST(HashSetTest, InsertGrowAndLookup) {
+    HashSet<int64_t> set;
+
+    // Multiples of a power of two would all share one slot without scrambling
+    for (int64_t i = 0; i < 5000; ++i) EXPECT_TRUE(set.insert(i << 20));
+    for (int64_t i = 0; i < 5000; ++i) EXPECT_FALSE(set.insert(i << 20));
+
+    EXPECT_EQ(set.size(), 5000);
+    EXPECT_TRUE(set.contains(int64_t(4999) << 20));
+    EXPECT_FALSE(set.contains(1));
+
+    int64_t total = 0;
+    set.forEach([&total] (int64_t value) {total += value >> 20;});
+    EXPECT_EQ(total, 4999 * 5000 / 2);
+}
+
+TEST(TypesHashTest, EqualValuesHashEqual) {
+    TypesHash hash;
+    TypesEqual equal;
+
+    EXPECT_EQ(hash(Types(3)), hash(Types(3.0f)));
+    EXPECT_EQ(hash(Types(int64_t(3))), hash(Types(int16_t(3))));
+    EXPECT_TRUE(equal(Types(3), Types(3.0f)));
+
+    EXPECT_EQ(hash(Types(SQLChar(5, "ab"))), hash(Types(SQLChar(3, "ab "))));
+    EXPECT_EQ(hash(Types(Varchar("ab"))), hash(Types(std::string("ab"))));
+    EXPECT_EQ(hash(Types(Date(2024, 2, 29))), hash(Types(Date(2024, 2, 29))));
+    EXPECT_EQ(hash(Types(Datetime(Date(2024, 2, 29), Time(12, 30, 0)))),
+              hash(Types(Datetime(Date(2024, 2, 29), Time(12, 30, 0)))));
+
+    EXPECT_TRUE(equal(Types(Null), Types(Null)));
+    EXPECT_FALSE(equal(Types(Null), Types(0)));
+
+    HashSet<Types, TypesHash, TypesEqual> cells;
+    for (const Types &cell : {Types(1), Types(1.0f), Types(Null), Types(Null), Types(std::string("1"))}) cells.insert(cell);
+    EXPECT_EQ(cells.size(), 3);
+}
+
+TEST_F(ColumnTest, DistinctThroughHashSets) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 4;
+
+    Column ints(Datatypes::INT, constraints);
+    for (Types cell : {Types(5), Types(Null), Types(7), Types(5), Types(9), Types(7), Types(Null), Types(5), Types(11)}) {
+        ints.push(cell);
+    }
+
+    auto indices = create_indices(ints.size());
+    EXPECT_EQ(ints.countDistinct(indices), 4);
+    EXPECT_DOUBLE_EQ(ints.sumDistinct(indices), 5 + 7 + 9 + 11);
+    EXPECT_DOUBLE_EQ(ints.avgDistinct(indices), 8);
+    EXPECT_EQ(ints.countDistinct({8, 0, 3}), 2);
+
+    Column dates(Datatypes::DATE, constraints);
+    for (int day : {1, 2, 1, 3, 2, 1}) dates.push(Date(2024, 1, day));
+    EXPECT_EQ(dates.countDistinct(create_indices(dates.size())), 3);
+
+    std::vector<Types> chars = {SQLChar(4, "ab"), SQLChar(4, "ab  "), SQLChar(4, "abc"), Null};
+    Column padded(chars, Datatypes::CHAR);
+    EXPECT_EQ(padded.countDistinct(create_indices(padded.size())), 2);
+
+    // Uniqueness of a bulk insert goes through the same sets
+    ColumnConstraints unique;
+    unique.Unique = true;
+    std::vector<Types> distinctCells = {Types(1), Types(2), Types(Null), Types(3)};
+    Column uniqueCol(distinctCells, Datatypes::INT, unique);
+    EXPECT_EQ(uniqueCol.size(), 4);
+
+    std::vector<Types> repeated = {Types(1), Types(2), Types(1)};
+    EXPECT_EXIT(Column(repeated, Datatypes::INT, unique), ::testing::ExitedWithCode(5), "");
+}
+
+TEST(HyperLogLogTest, EstimatesAndMerges) {
+    HyperLogLog small;
+    for (uint64_t i = 0; i < 100; ++i) small.add(i);
+    EXPECT_NEAR(small.estimate(), 100, 2);
+
+    // Two overlapping halves, merged: [0, 600000) and [400000, 1000000)
+    HyperLogLog left, right;
+    for (uint64_t i = 0; i < 600000; ++i) left.add(i);
+    for (uint64_t i = 400000; i < 1000000; ++i) right.add(i);
+    left.merge(right);
+    EXPECT_NEAR(left.estimate(), 1000000, 30000);
+
+    // Adding values again does not change the sketch
+    double before = left.estimate();
+    for (uint64_t i = 0; i < 1000; ++i) left.add(i);
+    EXPECT_DOUBLE_EQ(left.estimate(), before);
+
+    EXPECT_DEATH(HyperLogLog(3), "");
+    EXPECT_DEATH(left.merge(HyperLogLog(10)), "");
+}
+
+TEST_F(ColumnTest, ApproxCountDistinct) {
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 1000;
+
+    Column ids(Datatypes::BIGINT, constraints);
+    for (int i = 0; i < 20000; ++i) ids.push(i % 5 == 0 ? Types(Null) : Types(int64_t(i % 5000) * 7919));
+
+    auto indices = create_indices(ids.size());
+    int exact = ids.countDistinct(indices);
+    EXPECT_EQ(exact, 4000);
+    EXPECT_NEAR(ids.approxCountDistinct(indices), exact, exact * 0.03);
+
+    // Dictionary columns hash entries, not rows, but agree with plain text columns
+    ColumnConstraints dictionary;
+    dictionary.DictionaryEncoded = true;
+    Column encoded(Datatypes::TEXT, dictionary);
+    Column plain(Datatypes::TEXT);
+
+    for (int i = 0; i < 3000; ++i) {
+        encoded.push(std::string("user") + std::to_string(i % 300));
+        plain.push(std::string("user") + std::to_string(i % 300));
+    }
+
+    auto textIndices = create_indices(plain.size());
+    EXPECT_NEAR(plain.approxCountDistinct(textIndices), 300, 9);
+    EXPECT_EQ(encoded.approxCountDistinct(textIndices), plain.approxCountDistinct(textIndices));
+
+    HyperLogLog sketch = plain.distinctSketch(Selection::range(0, 150), 12);
+    sketch.merge(plain.distinctSketch(Selection::range(150, 3000), 12));
+    EXPECT_NEAR(sketch.estimate(), 300, 15);
+}
+
+TEST(TDigestTest, QuantilesAndMerge) {
+    // 0..99999 in a scrambled order, split over two digests
+    TDigest left, right;
+    for (int i = 0; i < 100000; ++i) {
+        double value = (int64_t(i) * 7919) % 100000;
+        (i % 2 ? left : right).add(value);
+    }
+    left.merge(right);
+
+    EXPECT_EQ(left.getCount(), 100000);
+    EXPECT_DOUBLE_EQ(left.quantile(0), 0);
+    EXPECT_DOUBLE_EQ(left.quantile(1), 99999);
+    EXPECT_NEAR(left.quantile(0.5), 50000, 500);
+    EXPECT_NEAR(left.quantile(0.95), 95000, 200);
+    EXPECT_NEAR(left.quantile(0.99), 99000, 100);
+
+    TDigest empty;
+    EXPECT_TRUE(std::isnan(empty.quantile(0.5)));
+
+    TDigest single;
+    single.add(42);
+    EXPECT_DOUBLE_EQ(single.quantile(0.3), 42);
+}
+
+TEST_F(ColumnTest, PercentilesAndMedian) {
+    std::vector<Types> data = {Types(7), Types(Null), Types(1), Types(3), Types(Null), Types(5), Types(9)};
+    Column col(data, Datatypes::INT);
+    auto indices = create_indices(col.size());
+
+    EXPECT_DOUBLE_EQ(col.median(indices), 5);
+    EXPECT_DOUBLE_EQ(col.percentile(indices, 0), 1);
+    EXPECT_DOUBLE_EQ(col.percentile(indices, 1), 9);
+    EXPECT_DOUBLE_EQ(col.percentile(indices, 0.25), 3);
+    EXPECT_DOUBLE_EQ(col.percentile(indices, 0.9), 8.2); // between 7 and 9
+    EXPECT_DOUBLE_EQ(col.median({0, 2, 3, 5}), 4);
+    EXPECT_TRUE(std::isnan(col.median({1, 4})));
+    EXPECT_EXIT(col.percentile(indices, 1.5), ::testing::ExitedWithCode(3), "");
+
+    ColumnConstraints constraints;
+    constraints.SegmentRows = 4096;
+    Column latencies(Datatypes::FLOAT, constraints);
+    for (int i = 0; i < 50000; ++i) latencies.push(float((int64_t(i) * 104729) % 50000) / 10);
+
+    auto all = create_indices(latencies.size());
+    for (double q : {0.5, 0.95, 0.99}) {
+        EXPECT_NEAR(latencies.approxPercentile(all, q), latencies.percentile(all, q), 25) << q;
+    }
+
+    TDigest digest = latencies.percentileSketch(Selection::range(0, 20000));
+    digest.merge(latencies.percentileSketch(Selection::range(20000, 50000)));
+    EXPECT_NEAR(digest.quantile(0.99), latencies.percentile(all, 0.99), 10);
+}
+
+TEST(TextCaseTest, KernelsMatchScalarCaseRules) {
+    // Long enough for the vector loops, with UTF-8 and punctuation in between
+    std::string text;
+    for (int i = 0; i < 20; ++i) text += "hello WORLD-3rd x_y \xC3\xA9t\xC3\xA9 MiXeD42case ";
+
+    std::string upper = text, lower = text, initCap = text;
+    asciiUpper(upper.data(), upper.size());
+    asciiLower(lower.data(), lower.size());
+    asciiInitCap(initCap.data(), initCap.size());
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        EXPECT_EQ(upper[i], 'a' <= c && c <= 'z' ? c - 32 : c) << i;
+        EXPECT_EQ(lower[i], 'A' <= c && c <= 'Z' ? c + 32 : c) << i;
+    }
+
+    std::string head = "Hello World-3rd X_Y \xC3\xA9T\xC3\xA9 Mixed42case Hello";
+    std::string tail = "\xC3\xA9T\xC3\xA9 Mixed42case ";
+    EXPECT_EQ(initCap.substr(0, head.size()), head);
+    EXPECT_EQ(initCap.substr(initCap.size() - tail.size()), tail);
+
+    std::string tiny = "aB";
+    asciiInitCap(tiny.data(), tiny.size());
+    EXPECT_EQ(tiny, "Ab");
+    asciiInitCap(tiny.data(), 0);
+}
+
+TEST_F(ColumnTest, CaseKernelsOnColumns) {
+    std::vector<Types> data = {std::string("abc"), Null, std::string("dEF ghi"), std::string(""), std::string("jkl")};
+    Column col(data, Datatypes::TEXT);
+    auto indices = create_indices(col.size());
+
+    // Rows are gathered into one buffer, words must not run over into the next row
+    Column capped = col.initCap(indices);
+    EXPECT_EQ(capped[0], Types(std::string("Abc")));
+    EXPECT_EQ(capped[1], Types(Null));
+    EXPECT_EQ(capped[2], Types(std::string("Def Ghi")));
+    EXPECT_EQ(capped[3], Types(std::string("")));
+    EXPECT_EQ(capped[4], Types(std::string("Jkl")));
+
+    EXPECT_EQ(col.upper({4, 2})[1], Types(std::string("DEF GHI")));
+    EXPECT_EQ(col.lower(indices)[2], Types(std::string("def ghi")));
+
+    ColumnConstraints dictionary;
+    dictionary.DictionaryEncoded = true;
+    Column encoded(data, Datatypes::TEXT, dictionary);
+    EXPECT_EQ(encoded.upper(indices)[2], Types(std::string("DEF GHI")));
+    EXPECT_EQ(encoded.upper(indices)[1], Types(Null));
+
+    // Dictionary encoded CHAR entries go through unpadded, like the plain ones
+    dictionary.CharLength = 6;
+    std::vector<Types> chars = {SQLChar(6, "ab"), SQLChar(6, "cD e")};
+    Column encodedChars(chars, Datatypes::CHAR, dictionary);
+    EXPECT_EQ(encodedChars.upper({0, 1})[0], Types(std::string("AB")));
+    EXPECT_EQ(encodedChars.lower({0, 1})[1], Types(std::string("cd e")));
+    EXPECT_EQ(encodedChars.initCap({0, 1})[1], Types(std::string("Cd E")));
+}
+
+TEST(AhoCorasickTest, LeftmostLongestMatches) {
+    auto matches = [] (const AhoCorasick &matcher, std::string_view text) {
+        std::vector<std::tuple<size_t, int, int>> found;
+        matcher.forEachMatch(text, [&found] (size_t start, int length, int pattern) {found.emplace_back(start, length, pattern);});
+        return found;
+    };
+
+    AhoCorasick matcher({"bc", "abcd", "he", "she", "hers", ""});
+    using Match = std::tuple<size_t, int, int>;
+
+    // "abcd" starts before "bc", "she" before "he", then "hers" is not overlapping anymore
+    EXPECT_EQ(matches(matcher, "xabcdx"), std::vector<Match>({{1, 4, 1}}));
+    EXPECT_EQ(matches(matcher, "abcx"), std::vector<Match>({{1, 2, 0}}));
+    EXPECT_EQ(matches(matcher, "ushers"), std::vector<Match>({{1, 3, 3}}));
+    EXPECT_EQ(matches(matcher, "hershe"), std::vector<Match>({{0, 4, 4}, {4, 2, 2}}));
+    EXPECT_TRUE(matches(matcher, "").empty());
+
+    AhoCorasick repeated({"aa"});
+    EXPECT_EQ(matches(repeated, "aaaaa"), std::vector<Match>({{0, 2, 0}, {2, 2, 0}}));
+}
+
+TEST_F(ColumnTest, ReplaceInOnePass) {
+    std::vector<Types> data = {std::string("a-b-c"), Null, std::string("aaa"), std::string("user=bob pass=hunter2")};
+    Column col(data, Datatypes::TEXT);
+    auto indices = create_indices(col.size());
+
+    // Replacements that contain the pattern used to loop forever
+    Column doubled = col.replace(indices, "a", "aa");
+    EXPECT_EQ(doubled[0], Types(std::string("aa-b-c")));
+    EXPECT_EQ(doubled[1], Types(Null));
+    EXPECT_EQ(doubled[2], Types(std::string("aaaaaa")));
+    EXPECT_EQ(col.replace(indices, "", "x")[0], Types(std::string("a-b-c")));
+
+    Column sanitized = col.replace(indices, {{"bob", "<user>"}, {"hunter2", "***"}, {"pass", "pw"}, {"-", ""}});
+    EXPECT_EQ(sanitized[3], Types(std::string("user=<user> pw=***")));
+    EXPECT_EQ(sanitized[0], Types(std::string("abc")));
+
+    // Swaps happen at once, a chain of replace calls would turn both into the same
+    Column swapped = col.replace(indices, {{"a", "b"}, {"b", "a"}});
+    EXPECT_EQ(swapped[0], Types(std::string("b-a-c")));
+
+    Column translated = col.translate(indices, "abc-", "xyz");
+    EXPECT_EQ(translated[0], Types(std::string("xyz")));
+    EXPECT_EQ(translated[2], Types(std::string("xxx")));
+    EXPECT_EQ(translated[1], Types(Null));
+}
+
+TEST(LikePatternTest, ShapesWildcardsAndEscapes) {
+    EXPECT_TRUE(LikePattern("abc").matches("abc"));
+    EXPECT_FALSE(LikePattern("abc").matches("abcd"));
+    EXPECT_TRUE(LikePattern("").matches(""));
+    EXPECT_TRUE(LikePattern("%%").matches(""));
+
+    EXPECT_TRUE(LikePattern("ab%").matches("abba"));
+    EXPECT_FALSE(LikePattern("ab%").matches("ba"));
+    EXPECT_TRUE(LikePattern("%ba").matches("abba"));
+    EXPECT_TRUE(LikePattern("%bb%").matches("abba"));
+    EXPECT_FALSE(LikePattern("%bb%").matches("abab"));
+
+    EXPECT_TRUE(LikePattern("a_c").matches("abc"));
+    EXPECT_FALSE(LikePattern("a_c").matches("ac"));
+    EXPECT_TRUE(LikePattern("___").matches("xyz"));
+
+    // Middle pieces taken at their leftmost place still leave room for the last one
+    EXPECT_TRUE(LikePattern("a%b%c").matches("abcbc"));
+    EXPECT_TRUE(LikePattern("a%b_c").matches("ab-bxc"));
+    EXPECT_FALSE(LikePattern("a%bc%c").matches("abc"));
+    EXPECT_TRUE(LikePattern("%a%a%").matches("banana"));
+    EXPECT_FALSE(LikePattern("%a%a%a%a%").matches("banana"));
+    EXPECT_FALSE(LikePattern("ab%ba").matches("aba"));
+
+    EXPECT_TRUE(LikePattern("100\\%").matches("100%"));
+    EXPECT_FALSE(LikePattern("100\\%").matches("1000"));
+    EXPECT_TRUE(LikePattern("a!_%", false, '!').matches("a_b"));
+    EXPECT_FALSE(LikePattern("a!_%", false, '!').matches("ab"));
+
+    EXPECT_TRUE(LikePattern("%BoB%", true).matches("i am bOb"));
+    EXPECT_FALSE(LikePattern("%BoB%").matches("i am bOb"));
+}
+
+TEST_F(ColumnTest, LikeSelections) {
+    std::vector<Types> data = {std::string("apple"), std::string("Apricot"), Null, 
+                               std::string("banana"), std::string("grape")};
+    Column col(data, Datatypes::TEXT);
+
+    EXPECT_EQ(col.like("ap%"), std::vector<int>({0}));
+    EXPECT_EQ(col.ilike("ap%"), std::vector<int>({0, 1}));
+    EXPECT_EQ(col.like("%ap%"), std::vector<int>({0, 4}));
+    EXPECT_EQ(col.like("_a%a_a"), std::vector<int>({3}));
+
+    // NULL is neither LIKE nor NOT LIKE anything
+    EXPECT_EQ(col.notLike("%ap%"), std::vector<int>({1, 3}));
+    EXPECT_EQ(col.notIlike("ap%"), std::vector<int>({3, 4}));
+
+    ColumnConstraints constraints;
+    constraints.DictionaryEncoded = true;
+    Column encoded(data, Datatypes::TEXT, constraints);
+
+    EXPECT_EQ(encoded.ilike("%p%"), std::vector<int>({0, 1, 4}));
+    EXPECT_EQ(encoded.notLike("%p%"), std::vector<int>({3}));
+
+    // CHAR padding is not part of the value
+    std::vector<Types> padded = {SQLChar(4, "ab"), SQLChar(4, "abc")};
+    Column chars(padded, Datatypes::CHAR);
+    EXPECT_EQ(chars.like("ab"), std::vector<int>({0}));
+    EXPECT_EQ(chars.like("%c"), std::vector<int>({1}));
+}
+
+TEST(RegexTest, SearchAgreesWithStdRegex) {
+    std::vector<std::string> patterns = {"abc", "a.c", "^ab", "bc$", "^$", "a*", "(ab|cd)+e", "x?y{2,3}z",
+                                         "[a-c]+[^a-c]", "\\d{3}-\\d{4}", "^(\\w+)@(\\w+)\\.com$", "a|^b|c$",
+                                         "(a|ab)(c|bcd)", "[]x]", "[a\\-z]", "\\s\\S", "(?:ab){2}", "a{0}b"};
+    std::vector<std::string> texts = {"", "abc", "xabcx", "ab", "bc", "cdcde", "abababe", "xyyz", "yyyyz", 
+                                      "aab!", "call 555-1234", "bob@example.com", "bob@mail.co", "b", "ac",
+                                      "abcd", "]", "-", "a b", "abab", "z"};
+
+    for (const auto &pattern : patterns) {
+        // Extended syntax has no escapes like \d or (?: groups
+        if (pattern.find('\\') != std::string::npos || pattern.find("?:") != std::string::npos) continue;
+
+        Regex regex(pattern);
+        std::regex reference(pattern, std::regex::extended);
+
+        for (const auto &text : texts) {
+            EXPECT_EQ(regex.search(text), std::regex_search(text, reference)) << pattern << " on " << text;
+        }
+    }
+
+    EXPECT_TRUE(Regex("\\d{3}-\\d{4}").search("call 555-1234"));
+    EXPECT_FALSE(Regex("\\d{3}-\\d{4}").search("call 55-1234"));
+    EXPECT_TRUE(Regex("^(\\w+)@(\\w+)\\.com$").search("bob@example.com"));
+    EXPECT_FALSE(Regex("^(\\w+)@(\\w+)\\.com$").search("bob@example.com."));
+    EXPECT_TRUE(Regex("(?:ab){2}").search("xababx"));
+    EXPECT_TRUE(Regex("hello", true).search("say HeLLo"));
+    EXPECT_TRUE(Regex("[^A-Z]", true).search("a1"));
+    EXPECT_FALSE(Regex("[^A-Z]", true).search("ab"));
+
+    // Leftmost, then longest
+    size_t start, length;
+    ASSERT_TRUE(Regex("(a|ab)(c|bcd)").find("xabcd", 0, start, length));
+    EXPECT_EQ(start, 1u);
+    EXPECT_EQ(length, 4u);
+
+    ASSERT_TRUE(Regex("b+|ab").find("aabbb", 0, start, length));
+    EXPECT_EQ(start, 1u);
+    EXPECT_EQ(length, 2u);
+
+    ASSERT_TRUE(Regex("x*").find("abc", 1, start, length));
+    EXPECT_EQ(start, 1u);
+    EXPECT_EQ(length, 0u);
+
+    EXPECT_FALSE(Regex("^b").find("ab", 1, start, length));
+
+    // The backward pass finds the same starts as trying every position forwards
+    for (const auto &pattern : patterns) {
+        Regex regex(pattern);
+
+        for (const auto &text : texts) {
+            std::vector<bool> starts;
+            regex.matchStarts(text, starts);
+
+            for (size_t from = 0; from <= text.size(); ++from) {
+                EXPECT_EQ(starts[from], regex.longestMatch(text, from) != std::string_view::npos) << pattern << " on " << text;
+
+                size_t expected = from;
+                while (expected <= text.size() && regex.longestMatch(text, expected) == std::string_view::npos) ++expected;
+
+                bool found = regex.find(text, from, start, length);
+                ASSERT_EQ(found, expected <= text.size()) << pattern << " on " << text << " from " << from;
+                if (found) {
+                    EXPECT_EQ(start, expected) << pattern << " on " << text << " from " << from;
+                    EXPECT_EQ(length, regex.longestMatch(text, expected));
+                }
+            }
+        }
+    }
+
+    // Linear: trying every start would go over the a's once per a
+    std::string as(200000, 'a');
+    ASSERT_TRUE(Regex("a*ab|c").find(as + "c", 0, start, length));
+    EXPECT_EQ(start, as.size());
+    EXPECT_EQ(length, 1u);
+
+    // One compiled automaton per pattern
+    EXPECT_EQ(Regex::compiled("a+b"), Regex::compiled("a+b"));
+    EXPECT_NE(Regex::compiled("a+b"), Regex::compiled("a+b", true));
+}
+
+TEST_F(ColumnTest, RegexpFunctions) {
+    std::vector<Types> data = {std::string("order 42 shipped"), Null, std::string("no digits"), 
+                               std::string("7 of 12")};
+    Column col(data, Datatypes::TEXT);
+    auto indices = create_indices(col.size());
+
+    EXPECT_EQ(col.regexpLike("\\d+"), std::vector<int>({0, 3}));
+    EXPECT_EQ(col.regexpLike("^NO", true), std::vector<int>({2}));
+
+    Column numbers = col.regexpExtract(indices, "\\d+");
+    EXPECT_EQ(numbers[0], Types(std::string("42")));
+    EXPECT_EQ(numbers[1], Types(Null));
+    EXPECT_EQ(numbers[2], Types(std::string("")));
+    EXPECT_EQ(numbers[3], Types(std::string("7")));
+
+    Column masked = col.regexpReplace(indices, "[0-9]+", "#");
+    EXPECT_EQ(masked[0], Types(std::string("order # shipped")));
+    EXPECT_EQ(masked[3], Types(std::string("# of #")));
+
+    Column spaced = col.regexpReplace(indices, "x*", "-");
+    EXPECT_EQ(spaced[3], Types(std::string("-7- -o-f- -1-2-")));
+
+    ColumnConstraints constraints;
+    constraints.DictionaryEncoded = true;
+    Column encoded(data, Datatypes::TEXT, constraints);
+    EXPECT_EQ(encoded.regexpLike("s$"), std::vector<int>({2}));
+}
+
+TEST(CalendarTest, ClosedFormMatchesDayByDayWalk) {
+    int year = 1, month = 1, day = 1;
+
+    for (int epoch = 1; year <= 9999; ++epoch) {
+        ASSERT_EQ(civilToEpoch(year, month, day), epoch) << year << "-" << month << "-" << day;
+
+        int y, m, d;
+        epochToCivil(epoch, y, m, d);
+        ASSERT_EQ(std::make_tuple(y, m, d), std::make_tuple(year, month, day)) << epoch;
+
+        bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+        if (++day > daysPerMonth[month - 1] + (month == 2 && leap)) {
+            day = 1;
+            if (++month > 12) {
+                month = 1;
+                ++year;
+            }
+        }
+    }
+
+    // Year 0 is a leap year right before 0001-01-01
+    EXPECT_EQ(civilToEpoch(0, 12, 31), 0);
+    EXPECT_EQ(civilToEpoch(0, 1, 1), -365);
+    EXPECT_EQ(Date(-365), Date(0, 1, 1));
+}
+
+TEST(CalendarTest, ExtractComponents) {
+    EXPECT_EQ(Date(2024, 1, 5).extract(DateComponents::DAYOFYEAR), 5);
+    EXPECT_EQ(Date(2024, 12, 31).extract(DateComponents::DAYOFYEAR), 366);
+    EXPECT_EQ(Date(2023, 3, 1).extract(DateComponents::DAYOFYEAR), 60);
+    EXPECT_EQ(Date(2024, 3, 1).extract(DateComponents::DAYOFYEAR), 61);
+    EXPECT_EQ(Date(2024, 8, 15).extract(DateComponents::QUARTERS), 3);
+
+    // ISO weeks near year ends belong to the year of their Thursday
+    EXPECT_EQ(Date(2021, 1, 1).extract(DateComponents::WEEKS), 53);
+    EXPECT_EQ(Date(2021, 1, 4).extract(DateComponents::WEEKS), 1);
+    EXPECT_EQ(Date(2024, 12, 30).extract(DateComponents::WEEKS), 1);
+    EXPECT_EQ(Date(2026, 10, 17).extract(DateComponents::WEEKS), 42);
+
+    std::vector<int32_t> epochs = {civilToEpoch(2025, 2, 28), civilToEpoch(1999, 12, 31), 1};
+    std::vector<int32_t> years(epochs.size());
+    extractEpochs(epochs.data(), epochs.size(), DateComponents::YEARS, years.data());
+    EXPECT_EQ(years, std::vector<int32_t>({2025, 1999, 1}));
+}
+
+TEST_F(ColumnTest, ExtractDateComponentsInBulk) {
+    std::vector<Types> dates = {Date(2024, 2, 29), Null, Date(2025, 12, 31), Date(1, 1, 1)};
+    Column col(dates, Datatypes::DATE);
+    auto all = create_indices(col.size());
+
+    for (auto mode : {DateComponents::DAYS, DateComponents::MONTHS, DateComponents::YEARS, 
+                      DateComponents::QUARTERS, DateComponents::WEEKS, DateComponents::DAYOFYEAR}) {
+        Column parts = col.extract(all, mode);
+        Column listed = col.extract(std::vector<int>({3, 2, 1, 0}), mode);
+
+        for (int i : {0, 2, 3}) {
+            EXPECT_EQ(parts[i], Types(static_cast<float>(std::get<Date>(dates[i]).extract(mode))));
+            EXPECT_EQ(listed[3 - i], parts[i]);
+        }
+        EXPECT_EQ(parts[1], Types(Null));
+    }
+
+    std::vector<Types> instants = {Datetime("2024-02-29 23:59:59"), Datetime("2025-01-01 00:00:00")};
+    Column timestamps(instants, Datatypes::DATETIME);
+    Column days = timestamps.extract(create_indices(timestamps.size()), DateComponents::DAYOFYEAR);
+    EXPECT_EQ(days[0], Types(60.0f));
+    EXPECT_EQ(days[1], Types(1.0f));
+
+    // Instants before 0001-01-01 are stored as negative microseconds
+    std::vector<Types> early = {Datetime(Date(0, 12, 31), Time(13, 45, 30)), Datetime(Date(0, 1, 1), Time(0, 0, 1))};
+    Column before(early, Datatypes::DATETIME);
+    auto both = create_indices(before.size());
+    EXPECT_EQ(before.extract(both, TimeComponents::HOURS)[0], Types(13.0f));
+    EXPECT_EQ(before.extract(both, TimeComponents::MINUTES)[0], Types(45.0f));
+    EXPECT_EQ(before.extract(both, TimeComponents::SECONDS)[0], Types(30.0f));
+    EXPECT_EQ(before.extract(both, TimeComponents::HOURS)[1], Types(0.0f));
+    EXPECT_EQ(before.extract(both, TimeComponents::SECONDS)[1], Types(1.0f));
+    EXPECT_EQ(before.extract(both, DateComponents::YEARS)[1], Types(0.0f));
+}
+
+TEST_F(ColumnTest, DateArithmeticOverColumns) {
+    std::vector<Types> dates = {Date(2024, 1, 31), Null, Date(2024, 2, 29), Date(2023, 12, 15), Date(1, 1, 1)};
+    Column col(dates, Datatypes::DATE);
+    auto all = create_indices(col.size());
+
+    for (auto mode : {DateComponents::DAYS, DateComponents::WEEKS, DateComponents::MONTHS, 
+                      DateComponents::QUARTERS, DateComponents::YEARS}) {
+        for (int difference : {1, -1, 13, 0}) {
+            Column moved = col.dateAdd(all, difference, mode);
+
+            for (int i : {0, 2, 3}) {
+                EXPECT_EQ(moved[i], Types(std::get<Date>(dates[i]).dateAdd(difference, mode)));
+            }
+            EXPECT_EQ(moved[1], Types(Null));
+        }
+    }
+
+    // Month ends clamp to the month landed on
+    Column nextMonth = col.dateAdd(all, 1, DateComponents::MONTHS);
+    EXPECT_EQ(nextMonth[0], Types(Date(2024, 2, 29)));
+    EXPECT_EQ(col.dateAdd(all, 1, DateComponents::YEARS)[2], Types(Date(2025, 2, 28)));
+    EXPECT_EQ(col.dateAdd(all, -2, DateComponents::MONTHS)[3], Types(Date(2023, 10, 15)));
+
+    std::vector<Types> instants = {Datetime("2024-01-31 23:30:00"), Datetime("2025-06-30 08:00:00"), Null};
+    Column timestamps(instants, Datatypes::DATETIME);
+    auto rows = create_indices(timestamps.size());
+
+    Column monthLater = timestamps.dateAdd(rows, 1, DateComponents::MONTHS);
+    EXPECT_EQ(monthLater[0], Types(Datetime("2024-02-29 23:30:00")));
+    EXPECT_EQ(monthLater[2], Types(Null));
+
+    Column later = timestamps.datetimeAdd(rows, 45, TimeComponents::MINUTES);
+    EXPECT_EQ(later[0], Types(Datetime("2024-02-01 00:15:00")));
+    EXPECT_EQ(later[1], Types(Datetime("2025-06-30 08:45:00")));
+
+    // Rows are paired up, DATE against DATETIME included
+    std::vector<Types> starts = {Date(2024, 1, 1), Date(2025, 7, 1), Date(2025, 1, 1)};
+    Column startCol(starts, Datatypes::DATE);
+
+    Column days = startCol.dateDiff(rows, timestamps, DateComponents::DAYS);
+    EXPECT_EQ(days[0], Types(30));
+    EXPECT_EQ(days[1], Types(-1));
+    EXPECT_EQ(days[2], Types(Null));
+
+    EXPECT_EQ(startCol.dateDiff(rows, timestamps, DateComponents::QUARTERS)[1], Types(-1));
+    EXPECT_EQ(startCol.dateDiff(rows, timestamps, TimeComponents::HOURS)[0], Types(30 * 24 + 23));
+
+    // Quarters are counted from the months they hold
+    EXPECT_EQ(dateDiff(Datetime("2025-07-01 00:00:00"), Datetime("2025-08-01 00:00:00"), DateComponents::QUARTERS), 0);
+    EXPECT_EQ(dateDiff(Datetime("2025-03-31 00:00:00"), Datetime("2025-04-01 00:00:00"), DateComponents::QUARTERS), 1);
+}
+
+TEST_F(ColumnTest, DateTruncAndTimeBuckets) {
+    std::vector<Types> dates = {Date(2024, 2, 29), Date(2024, 5, 17), Null, Date(2026, 10, 17)};
+    Column col(dates, Datatypes::DATE);
+    auto all = create_indices(col.size());
+
+    Column months = col.dateTrunc(all, DateComponents::MONTHS);
+    EXPECT_EQ(months[0], Types(Date(2024, 2, 1)));
+    EXPECT_EQ(months[2], Types(Null));
+
+    EXPECT_EQ(col.dateTrunc(all, DateComponents::QUARTERS)[1], Types(Date(2024, 4, 1)));
+    EXPECT_EQ(col.dateTrunc(all, DateComponents::YEARS)[3], Types(Date(2026, 1, 1)));
+
+    // 2026-10-17 is a Saturday
+    EXPECT_EQ(col.dateTrunc(all, DateComponents::WEEKS)[3], Types(Date(2026, 10, 12)));
+    EXPECT_EQ(col.timeBucket(all, 2, DateComponents::WEEKS)[3], Types(Date(2026, 10, 12)));
+    EXPECT_EQ(col.timeBucket(all, 3, DateComponents::WEEKS)[3], Types(Date(2026, 10, 5)));
+    EXPECT_EQ(col.timeBucket(all, 6, DateComponents::MONTHS)[1], Types(Date(2024, 1, 1)));
+    EXPECT_EQ(col.timeBucket(all, 10, DateComponents::YEARS)[3], Types(Date(2021, 1, 1)));
+
+    std::vector<Types> instants = {Datetime("2024-03-10 00:00:00"), Datetime("2024-03-10 13:47:12"), 
+                                   Datetime("2024-03-10 13:59:59"), Datetime("2024-03-11 01:00:00")};
+    Column timestamps(instants, Datatypes::DATETIME);
+    auto rows = create_indices(timestamps.size());
+
+    Column hours = timestamps.dateTrunc(rows, TimeComponents::HOURS);
+    EXPECT_EQ(hours[1], Types(Datetime("2024-03-10 13:00:00")));
+    EXPECT_EQ(timestamps.dateTrunc(rows, DateComponents::DAYS)[1], Types(Datetime("2024-03-10 00:00:00")));
+    EXPECT_EQ(timestamps.timeBucket(rows, 15, TimeComponents::MINUTES)[2], Types(Datetime("2024-03-10 13:45:00")));
+
+    // Sorted input stays sorted
+    Column buckets = timestamps.timeBucket(rows, 6, TimeComponents::HOURS);
+    for (int i = 1; i < buckets.size(); ++i) EXPECT_LE(buckets[i - 1], buckets[i]);
+
+    std::vector<Types> times = {Time(9, 31, 5), Time(23, 59, 59)};
+    Column clock(times, Datatypes::TIME);
+    EXPECT_EQ(clock.timeBucket(create_indices(2), 20, TimeComponents::MINUTES)[0], Types(Time(9, 20, 0)));
+}
+
+TEST(IsoParseTest, FixedWidthAndFallbackPaths) {
+    // Which inputs take the 8 bytes at a time path
+    EXPECT_TRUE(isFixedWidthDate("2024-02-29"));
+    EXPECT_TRUE(isFixedWidthDate("0001-01-01T00:00:00"));
+    for (const char *slow : {"2024-2-29", "2024-02-9", "2024/02/29", "2024-0a-29", "2024-02-2x", "24-02-29", "2024-02-2"}) {
+        EXPECT_FALSE(isFixedWidthDate(slow)) << slow;
+    }
+    EXPECT_TRUE(isFixedWidthTime("23:59:59.5"));
+    for (const char *slow : {"9:05:07", "23-59-59", "23:5a:59", "23:59:5"}) {
+        EXPECT_FALSE(isFixedWidthTime(slow)) << slow;
+    }
+
+    int32_t epoch = 0;
+    EXPECT_TRUE(parseIsoDate("2024-02-29", epoch));
+    EXPECT_EQ(epoch, Date(2024, 2, 29).epoch);
+    EXPECT_TRUE(parseIsoDate("2024-2-9", epoch));
+    EXPECT_EQ(epoch, Date(2024, 2, 9).epoch);
+    EXPECT_TRUE(parseIsoDate("0001-01-01", epoch));
+    EXPECT_EQ(epoch, 1);
+
+    for (const char *bad : {"2023-02-29", "2024-13-01", "2024-00-10", "2024-01-32", "2024/01/01", 
+                            "2024-01-01x", "20240101", "2024-0a-01", "", "-024-01-01", "2024-01-"}) {
+        EXPECT_FALSE(parseIsoDate(bad, epoch)) << bad;
+    }
+
+    int64_t micros = 0;
+    EXPECT_TRUE(parseIsoTime("13:45:30", micros));
+    EXPECT_EQ(micros, timeToMicros(Time(13, 45, 30)));
+    EXPECT_TRUE(parseIsoTime("9:05:07.25", micros));
+    EXPECT_EQ(micros, 9 * MICROS_PER_HOUR + 5 * MICROS_PER_MINUTE + 7 * MICROS_PER_SECOND + 250000);
+    EXPECT_TRUE(parseIsoTime("00:00:00.123456789", micros, 3));
+    EXPECT_EQ(micros, 123000);
+
+    for (const char *bad : {"24:00:00", "12:60:00", "12:00:60", "12:00", "12:00:00.", "12:00:00Z", "1a:00:00"}) {
+        EXPECT_FALSE(parseIsoTime(bad, micros)) << bad;
+    }
+
+    EXPECT_TRUE(parseIsoDatetime("2024-02-29T23:59:59.999999Z", micros));
+    EXPECT_EQ(micros, datetimeToMicros(Datetime(Date(2024, 2, 29), Time(23, 59, 59, 999999))));
+    EXPECT_TRUE(parseIsoDatetime("2024-2-29 1:02:03", micros));
+    EXPECT_EQ(micros, datetimeToMicros(Datetime(Date(2024, 2, 29), Time(1, 2, 3))));
+    EXPECT_TRUE(parseIsoDatetime("2024-02-29", micros));
+    EXPECT_EQ(micros, datetimeToMicros(Datetime(Date(2024, 2, 29), Time(0, 0, 0))));
+    EXPECT_FALSE(parseIsoDatetime("2024-02-29_10:00:00", micros));
+    EXPECT_FALSE(parseIsoDatetime("2024-02-29T", micros));
+
+    // The string constructors go through the same parsers
+    EXPECT_EQ(Time("10:30:15.29", 2).fraction, 29u);
+    EXPECT_EQ(Datetime("2025-06-21 10:00:01.5"), Datetime(Date(2025, 6, 21), Time(10, 0, 1, 500000)));
+}
+
+TEST_F(ColumnTest, ParseTemporalColumns) {
+    std::vector<Types> text = {std::string("2024-03-10 13:47:12.5"), Null, std::string("2025-01-01T00:00:00Z")};
+    Column col(text, Datatypes::TEXT);
+    auto all = create_indices(col.size());
+
+    Column timestamps = col.parseTemporal(all, Datatypes::DATETIME);
+    EXPECT_EQ(timestamps.type, Datatypes::DATETIME);
+    EXPECT_EQ(timestamps[0], Types(Datetime("2024-03-10 13:47:12.5")));
+    EXPECT_EQ(timestamps[1], Types(Null));
+    EXPECT_EQ(timestamps[2], Types(Datetime("2025-01-01 00:00:00")));
+
+    ColumnConstraints constraints;
+    constraints.DictionaryEncoded = true;
+    std::vector<Types> days = {std::string("2024-01-31"), std::string("1999-12-31"), std::string("2024-01-31")};
+    Column dates = Column(days, Datatypes::TEXT, constraints).parseTemporal(create_indices(3), Datatypes::DATE);
+    EXPECT_EQ(dates[0], Types(Date(2024, 1, 31)));
+    EXPECT_EQ(dates[1], Types(Date(1999, 12, 31)));
+
+    std::vector<Types> clock = {std::string("08:15:00"), std::string("23:59:59.999")};
+    Column times = Column(clock, Datatypes::TEXT).parseTemporal(create_indices(2), Datatypes::TIME, 3);
+    EXPECT_EQ(times[1], Types(Time(23, 59, 59, 999, 3)));
+}
+
+TEST(CsvParseTest, NumbersBoolsAndFields) {
+    int64_t integer = 0;
+    EXPECT_TRUE(parseInteger("-9223372036854775808", integer));
+    EXPECT_EQ(integer, std::numeric_limits<int64_t>::min());
+    EXPECT_TRUE(parseInteger("+32767", integer, 16));
+    EXPECT_EQ(integer, 32767);
+    EXPECT_TRUE(parseInteger("-2147483648", integer, 32));
+    EXPECT_EQ(integer, std::numeric_limits<int>::min());
+
+    for (const char *bad : {"32768", "-32769", "12a", "", "+", "+-1", " 1", "1.0"}) {
+        EXPECT_FALSE(parseInteger(bad, integer, 16)) << bad;
+    }
+    EXPECT_FALSE(parseInteger("9223372036854775808", integer));
+    EXPECT_EQ(integer, std::numeric_limits<int>::min());
+
+    float real = 0;
+    EXPECT_TRUE(parseFloat("-1.5e3", real));
+    EXPECT_FLOAT_EQ(real, -1500);
+    EXPECT_TRUE(parseFloat("+.25", real));
+    EXPECT_FLOAT_EQ(real, 0.25);
+    EXPECT_FALSE(parseFloat("1.5f", real));
+    EXPECT_FALSE(parseFloat("1e999", real));
+
+    bool boolean = false;
+    EXPECT_TRUE(parseBool("TRUE", boolean));
+    EXPECT_TRUE(boolean);
+    EXPECT_TRUE(parseBool("0", boolean));
+    EXPECT_FALSE(boolean);
+    EXPECT_FALSE(parseBool("yes", boolean));
+
+    std::vector<std::string> fields;
+    forEachField(" 1, two ,,\t3 ;", [&] (std::string_view field, int index) {
+        EXPECT_EQ(index, static_cast<int>(fields.size()));
+        fields.emplace_back(field);
+    });
+    EXPECT_EQ(fields, (std::vector<std::string>{"1", "two", "", "3"}));
+}
+
+TEST_F(ColumnTest, PushFieldsFromCsvText) {
+    Column ints(Datatypes::SMALLINT);
+    EXPECT_TRUE(ints.pushField("-12"));
+    EXPECT_TRUE(ints.pushField("NULL"));
+    EXPECT_TRUE(ints.pushField(""));
+    EXPECT_FALSE(ints.pushField("40000"));
+    EXPECT_FALSE(ints.pushField("twelve"));
+    ASSERT_EQ(ints.size(), 3);
+    EXPECT_EQ(ints[0], Types(static_cast<int16_t>(-12)));
+    EXPECT_EQ(ints[1], Types(Null));
+
+    Column flags(Datatypes::BOOL);
+    EXPECT_TRUE(flags.pushField("false"));
+    EXPECT_EQ(flags[0], Types(false));
+
+    ColumnConstraints precision;
+    precision.TimePrecision = 3;
+    Column stamps(Datatypes::DATETIME, precision);
+    EXPECT_TRUE(stamps.pushField("2024-03-10T13:47:12.123456"));
+    EXPECT_FALSE(stamps.pushField("2024-02-30"));
+    EXPECT_EQ(stamps[0], Types(Datetime(Date(2024, 3, 10), Time(13, 47, 12, 123, 3))));
+
+    Column chars(Datatypes::CHAR);
+    EXPECT_TRUE(chars.pushField("ab  "));
+    EXPECT_EQ(chars[0], Types(SQLChar(std::string("ab"))));
+
+    ColumnConstraints dictionary;
+    dictionary.DictionaryEncoded = true;
+    Column names(Datatypes::VARCHAR, dictionary);
+    for (const char *name : {"ann", "bob", "ann"}) EXPECT_TRUE(names.pushField(name));
+    EXPECT_EQ(names[2], Types(Varchar(std::string("ann"))));
+
+    // CHAR(n) reads back padded to n, whichever way its cells are stored
+    ColumnConstraints charN;
+    charN.CharLength = 4;
+    Column plainChars(Datatypes::CHAR, charN);
+    charN.DictionaryEncoded = true;
+    Column encodedChars(Datatypes::CHAR, charN);
+    for (const char *field : {"ab", "ab  ", "abcd"}) {
+        EXPECT_TRUE(plainChars.pushField(field));
+        EXPECT_TRUE(encodedChars.pushField(field));
+    }
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(static_cast<std::string>(std::get<SQLChar>(encodedChars[i])), 
+                  static_cast<std::string>(std::get<SQLChar>(plainChars[i])));
+    }
+    EXPECT_EQ(static_cast<std::string>(std::get<SQLChar>(encodedChars[0])), "ab  ");
+    EXPECT_EQ(encodedChars[0], encodedChars[1]);
+    EXPECT_EQ(encodedChars.countDistinct(create_indices(3)), 2);
+
+    ColumnConstraints strict;
+    strict.TakesNulls = false;
+    strict.DefaultValue = 0;
+    Column required(Datatypes::INT, strict);
+    EXPECT_EXIT(required.pushField("NULL"), ::testing::ExitedWithCode(5), "");
+}
+
+TEST(StringArenaTest, OverwriteEraseAndCompact) {
+    StringArena arena;
+    arena.push_back("alpha");
+    arena.push_back("");
+    arena.push_back("gamma");
+    EXPECT_EQ(arena.size(), 3);
+    EXPECT_EQ(arena[1], "");
+    EXPECT_EQ(arena.view(2), "gamma");
+
+    arena.set(0, "a");
+    EXPECT_EQ(arena[0], "a");
+    EXPECT_EQ(arena.wastedBytes(), 5);
+
+    // Once garbage outweighs live bytes the arena compacts itself
+    arena.erase(2);
+    EXPECT_EQ(arena.size(), 2);
+    EXPECT_EQ(arena.wastedBytes(), 0);
+    EXPECT_EQ(arena[0], "a");
+    EXPECT_EQ(arena[1], "");
+
+    arena.pop_back();
+    arena.pop_back();
+    EXPECT_EQ(arena.size(), 0);
+}
+
+TEST_F(ColumnTest, StringFunctionsOnArenaColumn) {
+    std::vector<Types> data = {std::string("  padded  "), std::monostate{}, std::string("aXbXc")};
+    Column col(data, Datatypes::TEXT);
+    auto indices = create_indices(col.size());
+
+    col.update(2, std::string("XaXbX"));
+    Column trimmed = col.trim(indices, TrimModes::BOTH);
+    EXPECT_EQ(std::get<std::string>(trimmed[0]), "padded");
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(trimmed[1]));
+
+    Column replaced = col.replace(indices, "X", "-");
+    EXPECT_EQ(std::get<std::string>(replaced[2]), "-a-b-");
+
+    Column left_col = col.left({2}, 2);
+    EXPECT_EQ(std::get<std::string>(left_col[0]), "Xa");
+    Column right_col = col.right({2}, 2);
+    EXPECT_EQ(std::get<std::string>(right_col[0]), "XaX");
+    EXPECT_EQ(col.left({2}, 9)[0], Types(std::string("XaXbX")));
+    EXPECT_EQ(col.right({2}, 9)[0], Types(std::string("")));
+    EXPECT_EXIT(col.left({2}, -1), ::testing::ExitedWithCode(9), "");
+    EXPECT_EXIT(col.right({2}, -1), ::testing::ExitedWithCode(9), "");
+
+    ColumnConstraints dictionary;
+    dictionary.DictionaryEncoded = true;
+    dictionary.CharLength = 6;
+    std::vector<Types> chars = {SQLChar(6, "ab"), SQLChar(6, " aXb")};
+    Column encodedChars(chars, Datatypes::CHAR, dictionary);
+    EXPECT_EQ(encodedChars.concat({0}, "x")[0], Types(std::string("abx")));
+    EXPECT_EQ(encodedChars.trim({1}, TrimModes::BOTH)[0], Types(std::string("aXb")));
+    EXPECT_EQ(encodedChars.substring({0}, 2, 5)[0], Types(std::string("b")));
+    EXPECT_EQ(encodedChars.replace({1}, "X", "-")[0], Types(std::string(" a-b")));
+}
 
 //##############################################################################
 // NUMERIC FUNCTION TESTS
@@ -0,0 +1,167 @@
+#include "textcase.h"
+
+// SSE2 is part of x86-64, the AVX2 versions are compiled regardless of the build
+// flags and picked at runtime (same as the predicate kernels)
+#if defined(__GNUC__) && defined(__x86_64__)
+#define TEXTCASE_SIMD 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr char CASE_BIT = 0x20;
+
+inline bool between(const char c, const char low, const char high) {
+  return low <= c && c <= high;
+}
+
+inline bool isAlnum(const char c) {
+  return between(c, 'a', 'z') || between(c, 'A', 'Z') || between(c, '0', '9');
+}
+
+template <bool Upper>
+void caseScalar(char *bytes, const size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    bool flips = Upper ? between(bytes[i], 'a', 'z') : between(bytes[i], 'A', 'Z');
+    bytes[i] ^= flips ? CASE_BIT : 0;
+  }
+}
+
+// Letters only change case, so whether bytes[i - 1] is alphanumeric doesn't depend on
+// it having been rewritten already
+void initCapScalar(char *bytes, const size_t from, const size_t count) {
+  for (size_t i = from; i < count; ++i) {
+    bool startsWord = i == 0 || !isAlnum(bytes[i - 1]);
+    bool flips = startsWord ? between(bytes[i], 'a', 'z') : between(bytes[i], 'A', 'Z');
+    bytes[i] ^= flips ? CASE_BIT : 0;
+  }
+}
+
+#ifdef TEXTCASE_SIMD
+
+// Bytes >= 0x80 are negative as signed chars, so they never fall in an ASCII range
+inline __m128i between(const __m128i x, const char low, const char high) {
+  return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(low - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(high + 1), x));
+}
+
+inline __m128i isAlnum(const __m128i x) {
+  return _mm_or_si128(_mm_or_si128(between(x, 'a', 'z'), between(x, 'A', 'Z')), between(x, '0', '9'));
+}
+
+inline __m128i flip(const __m128i x, const __m128i mask) {
+  return _mm_xor_si128(x, _mm_and_si128(mask, _mm_set1_epi8(CASE_BIT)));
+}
+
+// Returns how many bytes were done, the rest is left to the scalar loop
+template <bool Upper>
+size_t caseSse2(char *bytes, const size_t count) {
+  size_t i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m128i *at = reinterpret_cast<__m128i *>(bytes + i);
+    __m128i x = _mm_loadu_si128(at);
+    _mm_storeu_si128(at, flip(x, Upper ? between(x, 'a', 'z') : between(x, 'A', 'Z')));
+  }
+
+  return i;
+}
+
+// Each block also loads the block shifted back by one byte, which gives every byte
+// its predecessor. Starts at 1, bytes[0] is left to the scalar loop
+size_t initCapSse2(char *bytes, const size_t count) {
+  size_t i = 1;
+
+  for (; i + 16 <= count; i += 16) {
+    __m128i *at = reinterpret_cast<__m128i *>(bytes + i);
+    __m128i x = _mm_loadu_si128(at);
+    __m128i previous = isAlnum(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i - 1)));
+
+    __m128i toUpper = _mm_andnot_si128(previous, between(x, 'a', 'z'));
+    __m128i toLower = _mm_and_si128(previous, between(x, 'A', 'Z'));
+    _mm_storeu_si128(at, flip(x, _mm_or_si128(toUpper, toLower)));
+  }
+
+  return i;
+}
+
+TARGET_AVX2 inline __m256i between(const __m256i x, const char low, const char high) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(low - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), x));
+}
+
+TARGET_AVX2 inline __m256i isAlnum(const __m256i x) {
+  return _mm256_or_si256(_mm256_or_si256(between(x, 'a', 'z'), between(x, 'A', 'Z')), between(x, '0', '9'));
+}
+
+TARGET_AVX2 inline __m256i flip(const __m256i x, const __m256i mask) {
+  return _mm256_xor_si256(x, _mm256_and_si256(mask, _mm256_set1_epi8(CASE_BIT)));
+}
+
+template <bool Upper>
+TARGET_AVX2 size_t caseAvx2(char *bytes, const size_t count) {
+  size_t i = 0;
+
+  for (; i + 32 <= count; i += 32) {
+    __m256i *at = reinterpret_cast<__m256i *>(bytes + i);
+    __m256i x = _mm256_loadu_si256(at);
+    _mm256_storeu_si256(at, flip(x, Upper ? between(x, 'a', 'z') : between(x, 'A', 'Z')));
+  }
+
+  return i;
+}
+
+TARGET_AVX2 size_t initCapAvx2(char *bytes, const size_t count) {
+  size_t i = 1;
+
+  for (; i + 32 <= count; i += 32) {
+    __m256i *at = reinterpret_cast<__m256i *>(bytes + i);
+    __m256i x = _mm256_loadu_si256(at);
+    __m256i previous = isAlnum(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i - 1)));
+
+    __m256i toUpper = _mm256_andnot_si256(previous, between(x, 'a', 'z'));
+    __m256i toLower = _mm256_and_si256(previous, between(x, 'A', 'Z'));
+    _mm256_storeu_si256(at, flip(x, _mm256_or_si256(toUpper, toLower)));
+  }
+
+  return i;
+}
+
+bool hasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+#endif
+
+template <bool Upper>
+void foldCase(char *bytes, const size_t count) {
+  size_t done = 0;
+
+#ifdef TEXTCASE_SIMD
+  done = hasAvx2() ? caseAvx2<Upper>(bytes, count) : caseSse2<Upper>(bytes, count);
+#endif
+
+  caseScalar<Upper>(bytes + done, count - done);
+}
+
+} // namespace
+
+void asciiUpper(char *bytes, size_t count) {
+  foldCase<true>(bytes, count);
+}
+
+void asciiLower(char *bytes, size_t count) {
+  foldCase<false>(bytes, count);
+}
+
+void asciiInitCap(char *bytes, size_t count) {
+  size_t done = 0;
+
+#ifdef TEXTCASE_SIMD
+  done = hasAvx2() ? initCapAvx2(bytes, count) : initCapSse2(bytes, count);
+#endif
+
+  // Also covers bytes[0] when the vector loops didn't run
+  if (done > 1) initCapScalar(bytes, 0, 1);
+  initCapScalar(bytes, done > 1 ? done : 0, count);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+using namespace std;
+
+// Case kernels, in place over bytes[0, count). Only ASCII letters change: every byte
+// of a UTF-8 multibyte sequence is >= 0x80, so those pass through untouched.
+// On x86 they run 16 bytes at a time (SSE2), or 32 on CPUs with AVX2
+
+void asciiUpper(char *bytes, size_t count);
+void asciiLower(char *bytes, size_t count);
+
+// Upper-cases letters that start a word and lower-cases the others. Words are runs
+// of ASCII letters and digits, so a letter right after a digit is lower-cased ("3Rd"
+// becomes "3rd"). bytes[0] always starts a word
+void asciiInitCap(char *bytes, size_t count);